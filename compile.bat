@@ -1,3 +1,6 @@
 mkdir build
 glslc src\shaders\shader.vert -o build\vert.spv
-glslc src\shaders\shader.frag -o build\frag.spv
\ No newline at end of file
+glslc src\shaders\shader.frag -o build\frag.spv
+glslc src\shaders\mesh.vert -o build\mesh_vert.spv
+glslc src\shaders\multiview.vert -o build\multiview_vert.spv
+glslc src\shaders\mesh.frag -o build\mesh_frag.spv
\ No newline at end of file
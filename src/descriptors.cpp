@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+#include "headers/descriptors.h"
+
+// Public
+void DescriptorAllocator::create(VkDevice device, uint32_t framesInFlight) {
+    this->device = device;
+    framePools.resize(framesInFlight);
+    currentFrame = 0;
+    setsPerPool = initialSetsPerPool;
+    poolCount = 0;
+    frameSets = 0;
+}
+
+void DescriptorAllocator::destroy() {
+    if (VK_NULL_HANDLE == device) { return; }
+
+    for (auto &pools: framePools) {
+        for (auto pool: pools) { vkDestroyDescriptorPool(device, pool, VK_NULL_HANDLE); }
+    }
+    for (auto pool: persistentPools) { vkDestroyDescriptorPool(device, pool, VK_NULL_HANDLE); }
+    for (auto pool: freePools) { vkDestroyDescriptorPool(device, pool, VK_NULL_HANDLE); }
+
+    framePools.clear();
+    persistentPools.clear();
+    freePools.clear();
+    device = VK_NULL_HANDLE;
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frame) {
+    currentFrame = frame;
+    frameSets = 0;
+
+    // Resetting frees every set at once, the pools go back to the free list for whichever frame needs them next
+    for (auto pool: framePools[frame]) {
+        vkResetDescriptorPool(device, pool, 0);
+        freePools.push_back(pool);
+    }
+    framePools[frame].clear();
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+    frameSets++;
+    return allocateFrom(framePools[currentFrame], layout);
+}
+
+VkDescriptorSet DescriptorAllocator::allocatePersistent(VkDescriptorSetLayout layout) {
+    return allocateFrom(persistentPools, layout);
+}
+
+
+// Private
+VkDescriptorSet DescriptorAllocator::allocateFrom(std::vector<VkDescriptorPool> &pools,
+                                                  VkDescriptorSetLayout layout) {
+    if (pools.empty()) { pools.push_back(acquirePool()); }
+
+    VkDescriptorSetAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = pools.back(),
+            .descriptorSetCount = 1,
+            .pSetLayouts = &layout,
+    };
+
+    VkDescriptorSet descriptorSet;
+    VkResult result = vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet);
+
+    // Only the newest pool can still have room, a full one is left alone until it is reset
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+        pools.push_back(acquirePool());
+        allocInfo.descriptorPool = pools.back();
+        result = vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet);
+    }
+
+    if (result != VK_SUCCESS) { throw std::runtime_error("Failed to allocate descriptor set!"); }
+    return descriptorSet;
+}
+
+VkDescriptorPool DescriptorAllocator::acquirePool() {
+    if (!freePools.empty()) {
+        VkDescriptorPool pool = freePools.back();
+        freePools.pop_back();
+        return pool;
+    }
+
+    // Descriptors per set for each type, scaled by the number of sets in the pool
+    constexpr std::array<std::pair<VkDescriptorType, uint32_t>, 6> ratios = {{
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4},
+            {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1},
+    }};
+
+    std::array<VkDescriptorPoolSize, ratios.size()> poolSizes{};
+    for (size_t i = 0; i < ratios.size(); i++) {
+        poolSizes[i] = {.type = ratios[i].first, .descriptorCount = ratios[i].second * setsPerPool};
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .maxSets = setsPerPool,
+            .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+            .pPoolSizes = poolSizes.data(),
+    };
+
+    VkDescriptorPool pool;
+    if (vkCreateDescriptorPool(device, &poolInfo, VK_NULL_HANDLE, &pool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create descriptor pool!");
+    }
+
+    poolCount++;
+    setsPerPool = std::min(setsPerPool * 2, maxSetsPerPool);
+    return pool;
+}
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "headers/drawlist.h"
+
+// Public
+uint32_t DrawList::addPipeline(VkPipeline pipeline, VkPipelineLayout layout) {
+    if (pipelines.size() >= (1u << pipelineBits)) { throw std::runtime_error("Too many draw list pipelines!"); }
+    pipelines.push_back({pipeline, layout});
+    return static_cast<uint32_t>(pipelines.size() - 1);
+}
+
+uint32_t DrawList::addMaterial(VkDescriptorSet descriptorSet) {
+    if (materials.size() >= (1u << materialBits)) { throw std::runtime_error("Too many draw list materials!"); }
+    materials.push_back(descriptorSet);
+    return static_cast<uint32_t>(materials.size() - 1);
+}
+
+uint32_t DrawList::addMesh(const Mesh &mesh) {
+    if (meshes.size() >= (1u << meshBits)) { throw std::runtime_error("Too many draw list meshes!"); }
+    meshes.push_back(mesh);
+    return static_cast<uint32_t>(meshes.size() - 1);
+}
+
+void DrawList::clear() {
+    draws.clear();
+    keys.clear();
+    order.clear();
+}
+
+void DrawList::add(const Draw &draw) {
+    if (draw.pipeline >= pipelines.size() || draw.material >= materials.size() || draw.mesh >= meshes.size()) {
+        throw std::runtime_error("Draw references an unregistered resource!");
+    }
+
+    order.push_back(static_cast<uint32_t>(draws.size()));
+    keys.push_back(makeKey(draw));
+    draws.push_back(draw);
+}
+
+void DrawList::sort(JobSystem &jobSystem) {
+    const auto count = static_cast<uint32_t>(keys.size());
+    if (count < 2) { return; }
+
+    scratchKeys.resize(count);
+    scratchOrder.resize(count);
+
+    const uint32_t chunkCount = (count + sortChunkSize - 1) / sortChunkSize;
+    histograms.resize(chunkCount * 256);
+
+    // Bytes that are equal in every key would only copy the data, those passes are skipped
+    uint64_t differing = 0;
+    for (uint32_t i = 1; i < count; i++) { differing |= keys[i] ^ keys[0]; }
+
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        if (((differing >> shift) & 0xFF) == 0) { continue; }
+
+        jobSystem.parallelFor(chunkCount, 1, [this, shift, count](uint32_t begin, uint32_t end) {
+            for (uint32_t chunk = begin; chunk < end; chunk++) {
+                uint32_t *histogram = &histograms[chunk * 256];
+                std::fill(histogram, histogram + 256, 0);
+
+                const uint32_t last = std::min((chunk + 1) * sortChunkSize, count);
+                for (uint32_t i = chunk * sortChunkSize; i < last; i++) { histogram[(keys[i] >> shift) & 0xFF]++; }
+            }
+        });
+
+        // Digit major, chunk minor offsets: chunks scatter in their original order, which keeps every pass stable
+        uint32_t offset = 0;
+        for (uint32_t digit = 0; digit < 256; digit++) {
+            for (uint32_t chunk = 0; chunk < chunkCount; chunk++) {
+                uint32_t &entry = histograms[chunk * 256 + digit];
+                uint32_t digitCount = entry;
+                entry = offset;
+                offset += digitCount;
+            }
+        }
+
+        jobSystem.parallelFor(chunkCount, 1, [this, shift, count](uint32_t begin, uint32_t end) {
+            for (uint32_t chunk = begin; chunk < end; chunk++) {
+                uint32_t *histogram = &histograms[chunk * 256];
+
+                const uint32_t last = std::min((chunk + 1) * sortChunkSize, count);
+                for (uint32_t i = chunk * sortChunkSize; i < last; i++) {
+                    uint32_t destination = histogram[(keys[i] >> shift) & 0xFF]++;
+                    scratchKeys[destination] = keys[i];
+                    scratchOrder[destination] = order[i];
+                }
+            }
+        });
+
+        keys.swap(scratchKeys);
+        order.swap(scratchOrder);
+    }
+}
+
+DrawList::BindStats DrawList::record(VkCommandBuffer commandBuffer, VkDescriptorSet objectSet,
+                                     uint32_t objectOffset) const {
+    constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    BindStats stats{};
+    uint32_t boundPipeline = none;
+    uint32_t boundMaterial = none;
+    uint32_t boundMesh = none;
+    VkPipelineLayout boundLayout = VK_NULL_HANDLE;
+
+    for (uint32_t index: order) {
+        const Draw &draw = draws[index];
+        const PipelineEntry &pipeline = pipelines[draw.pipeline];
+
+        if (draw.pipeline != boundPipeline) {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.pipeline);
+            // Bound sets survive a pipeline change as long as the layout stays the same
+            if (pipeline.layout != boundLayout) {
+                vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout,
+                                        objectSetIndex, 1, &objectSet, 1, &objectOffset);
+                boundMaterial = none;
+                stats.descriptorBinds++;
+            }
+            boundPipeline = draw.pipeline;
+            boundLayout = pipeline.layout;
+            stats.pipelineBinds++;
+        }
+
+        // The object set stays bound, only the material set is replaced
+        if (draw.material != boundMaterial) {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout,
+                                    materialSetIndex, 1, &materials[draw.material], 0, VK_NULL_HANDLE);
+            boundMaterial = draw.material;
+            stats.materialBinds++;
+            stats.descriptorBinds++;
+        }
+
+        const Mesh &mesh = meshes[draw.mesh];
+        if (draw.mesh != boundMesh) {
+            if (VK_NULL_HANDLE != mesh.vertexBuffer) {
+                VkDeviceSize offset = 0;
+                vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mesh.vertexBuffer, &offset);
+                if (VK_NULL_HANDLE != mesh.indexBuffer) {
+                    vkCmdBindIndexBuffer(commandBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+                }
+                stats.meshBinds++;
+            }
+            boundMesh = draw.mesh;
+        }
+
+        if (VK_NULL_HANDLE != mesh.indexBuffer) {
+            vkCmdDrawIndexed(commandBuffer, mesh.count, 1, 0, 0, draw.object);
+        } else {
+            vkCmdDraw(commandBuffer, mesh.count, 1, 0, draw.object);
+        }
+        stats.draws++;
+    }
+
+    return stats;
+}
+
+uint64_t DrawList::makeKey(const Draw &draw) {
+    // Non negative floats order like their bit patterns, the top bits are plenty to sort by
+    uint32_t depthBitPattern;
+    const float depth = std::max(draw.depth, 0.0f);
+    std::memcpy(&depthBitPattern, &depth, sizeof(depth));
+    const uint64_t quantizedDepth = depthBitPattern >> (32 - depthBits);
+
+    const uint64_t state = (static_cast<uint64_t>(draw.pipeline) << (materialBits + meshBits)) |
+                           (static_cast<uint64_t>(draw.material) << meshBits) | draw.mesh;
+
+    if (draw.pass == Pass::Opaque) { return (state << depthBits) | quantizedDepth; }
+
+    const uint64_t farFirst = ~quantizedDepth & ((1ull << depthBits) - 1);
+    return (1ull << 63) | (farFirst << (pipelineBits + materialBits + meshBits)) | state;
+}
@@ -0,0 +1,72 @@
+#ifndef STARTER_DESCRIPTORS_H
+#define STARTER_DESCRIPTORS_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Hands out descriptor sets from pools that grow on demand and are recycled as a whole.
+ *
+ * Sets allocated for a frame live until that frame index comes around again: beginFrame() resets every pool the frame
+ * used with vkResetDescriptorPool and returns them to a shared free list, so individual sets are never freed.
+ * Persistent sets (e.g. the dynamic uniform buffer binding, written once) come from separate pools that are only
+ * released by destroy().
+ */
+class DescriptorAllocator {
+public:
+    struct Stats {
+        uint32_t poolCount;     // Every pool created, in use or free
+        uint32_t frameSets;     // Sets allocated for the current frame
+        uint32_t framePools;    // Pools the current frame draws from
+    };
+
+    // Sets per pool grow geometrically from the first pool up to the cap
+    static constexpr uint32_t initialSetsPerPool = 64;
+    static constexpr uint32_t maxSetsPerPool = 4096;
+
+    void create(VkDevice device, uint32_t framesInFlight);
+    void destroy();
+
+    /**
+     * Reset the pools of the frame's previous use, the GPU must be done with it
+     *
+     * @param frame Frame in flight index
+     */
+    void beginFrame(uint32_t frame);
+
+    /**
+     * Set valid until the current frame index is begun again
+     *
+     * @param layout
+     * @return
+     */
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+    /**
+     * Set valid until destroy()
+     *
+     * @param layout
+     * @return
+     */
+    VkDescriptorSet allocatePersistent(VkDescriptorSetLayout layout);
+
+    [[nodiscard]] Stats getStats() const {
+        return {poolCount, frameSets, static_cast<uint32_t>(framePools[currentFrame].size())};
+    }
+
+private:
+    VkDevice device = VK_NULL_HANDLE;
+    std::vector<std::vector<VkDescriptorPool>> framePools;
+    std::vector<VkDescriptorPool> persistentPools;
+    std::vector<VkDescriptorPool> freePools;
+    uint32_t currentFrame = 0;
+    uint32_t setsPerPool = initialSetsPerPool;
+    uint32_t poolCount = 0;
+    uint32_t frameSets = 0;
+
+    VkDescriptorSet allocateFrom(std::vector<VkDescriptorPool> &pools, VkDescriptorSetLayout layout);
+    VkDescriptorPool acquirePool();
+};
+
+#endif  //STARTER_DESCRIPTORS_H
@@ -0,0 +1,113 @@
+#ifndef STARTER_DRAWLIST_H
+#define STARTER_DRAWLIST_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#include "jobs.h"
+
+/**
+ * Per-frame list of draws sorted by a 64-bit key so that recording binds as little state as possible.
+ *
+ * Opaque key:      [63] 0 | pipeline 11 | material 14 | mesh 14 | depth 24 (front to back)
+ * Transparent key: [63] 1 | inverted depth 24 (back to front) | pipeline 11 | material 14 | mesh 14
+ *
+ * Opaque draws come first and are grouped by state, so each pipeline / material / mesh is bound once per run, with
+ * depth only ordering draws that share all of it. Transparent draws must blend in order, so depth dominates.
+ *
+ * Pipelines, materials and meshes are registered once and referenced by index. Materials are bound at
+ * materialSetIndex. Per-object uniforms of the whole frame live in one block bound once at objectSetIndex, and each
+ * draw selects its entry through firstInstance, so a sorted list only calls vkCmdBindDescriptorSets when the material
+ * or the pipeline layout changes.
+ */
+class DrawList {
+public:
+    enum class Pass : uint8_t { Opaque, Transparent };
+
+    struct Draw {
+        uint32_t pipeline;
+        uint32_t material;
+        uint32_t mesh;
+        float depth;  // View space distance, only the order matters
+        Pass pass;
+        uint32_t object;  // Index of the object's uniforms in the frame's block, read as gl_InstanceIndex
+    };
+
+    struct Mesh {
+        VkBuffer vertexBuffer;  // VK_NULL_HANDLE for meshes generated in the vertex shader
+        VkBuffer indexBuffer;   // VK_NULL_HANDLE for non indexed meshes
+        uint32_t count;         // Index count when indexed, vertex count otherwise
+    };
+
+    struct BindStats {
+        uint32_t draws;
+        uint32_t pipelineBinds;
+        uint32_t materialBinds;
+        uint32_t meshBinds;
+        uint32_t descriptorBinds;  // Every vkCmdBindDescriptorSets call, object set binds included
+    };
+
+    static constexpr uint32_t pipelineBits = 11;
+    static constexpr uint32_t materialBits = 14;
+    static constexpr uint32_t meshBits = 14;
+    static constexpr uint32_t depthBits = 24;
+
+    static constexpr uint32_t materialSetIndex = 0;
+    static constexpr uint32_t objectSetIndex = 1;
+
+    // Draws per radix sort job. A chunk costs a few microseconds per pass, about what it takes to hand a job to a
+    // worker, so smaller chunks would not pay off. Scenes of a few hundred draws are sorted by a single job.
+    static constexpr uint32_t sortChunkSize = 2048;
+
+    uint32_t addPipeline(VkPipeline pipeline, VkPipelineLayout layout);
+    uint32_t addMaterial(VkDescriptorSet descriptorSet);
+    uint32_t addMesh(const Mesh &mesh);
+
+    /**
+     * Forget the draws of the previous frame, registered resources are kept
+     */
+    void clear();
+    void add(const Draw &draw);
+
+    /**
+     * Order the draws by key with a parallel LSD radix sort. Without it, draws are recorded in submission order.
+     *
+     * @param jobSystem
+     */
+    void sort(JobSystem &jobSystem);
+
+    /**
+     * Record every draw, only binding state that differs from the previous draw
+     *
+     * @param commandBuffer Inside a render pass compatible with the registered pipelines
+     * @param objectSet Set with the dynamic uniform buffer holding per-object data
+     * @param objectOffset Dynamic offset of the frame's block of per-object uniforms
+     * @return
+     */
+    BindStats record(VkCommandBuffer commandBuffer, VkDescriptorSet objectSet, uint32_t objectOffset) const;
+
+    [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(draws.size()); }
+
+    static uint64_t makeKey(const Draw &draw);
+
+private:
+    struct PipelineEntry {
+        VkPipeline pipeline;
+        VkPipelineLayout layout;
+    };
+
+    std::vector<PipelineEntry> pipelines;
+    std::vector<VkDescriptorSet> materials;
+    std::vector<Mesh> meshes;
+
+    std::vector<Draw> draws;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> order;  // Indices into draws in recording order
+    // Radix sort ping-pong buffers and per chunk digit counts, kept to avoid allocating every frame
+    std::vector<uint64_t> scratchKeys;
+    std::vector<uint32_t> scratchOrder;
+    std::vector<uint32_t> histograms;
+};
+
+#endif  //STARTER_DRAWLIST_H
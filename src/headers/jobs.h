@@ -0,0 +1,123 @@
+#ifndef STARTER_JOBS_H
+#define STARTER_JOBS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Work stealing thread pool used for startup, asset loading and any other CPU side renderer work.
+ *
+ * Every worker owns a deque: it pushes and pops its own jobs at the back (LIFO, cache warm) while idle workers steal
+ * from the front of the others. Jobs can depend on other jobs and only become runnable once all of them finished.
+ * Jobs with MainThread affinity (GLFW window calls) are queued separately and run by the main thread inside wait()
+ * or runMainThreadJobs().
+ *
+ * An exception thrown by a job is stored, skips every job depending on it and is rethrown by wait().
+ */
+class JobSystem {
+public:
+    enum class Affinity { Any, MainThread };
+
+    struct Job {
+        std::function<void()> task;
+        Affinity affinity = Affinity::Any;
+        std::atomic<uint32_t> pendingDependencies{1};
+        std::atomic<bool> done{false};
+        std::mutex mutex;  // Guards continuations, done transitions and error
+        std::vector<std::shared_ptr<Job>> continuations;
+        std::exception_ptr error;
+    };
+
+    using JobHandle = std::shared_ptr<Job>;
+
+    JobSystem() = default;
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+    ~JobSystem() { destroy(); }
+
+    /**
+     * Start the workers, must be called from the thread that is treated as the main thread
+     *
+     * @param workerCount 0 runs every job on the main thread inside wait()
+     */
+    void create(uint32_t workerCount);
+    void destroy();
+
+    /**
+     * Queue a task that runs once every dependency has finished
+     *
+     * @param task
+     * @param dependencies
+     * @param affinity
+     * @return Handle to wait on or to pass as a dependency
+     */
+    JobHandle schedule(std::function<void()> task, const std::vector<JobHandle> &dependencies = {},
+                       Affinity affinity = Affinity::Any);
+
+    /**
+     * Block until the job finished, running other jobs meanwhile. Rethrows the job's exception.
+     *
+     * @param job
+     */
+    void wait(const JobHandle &job);
+
+    /**
+     * Split [0, count) into chunks of grainSize and run body(begin, end) on each in parallel, returns when all are
+     * done. If chunks throw, the first error is rethrown only after every chunk has finished.
+     *
+     * @param count
+     * @param grainSize
+     * @param body
+     */
+    void parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)> &body);
+
+    /**
+     * Run every queued main thread job, to be called regularly by the main loop
+     */
+    void runMainThreadJobs();
+
+    [[nodiscard]] uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+private:
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::deque<JobHandle> jobs;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex mainThreadMutex;
+    std::deque<JobHandle> mainThreadJobs;
+    std::thread::id mainThreadId;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;  // Idle workers
+    std::condition_variable doneCondition;  // Threads blocked in wait()
+    std::atomic<uint32_t> waitingThreads{0};
+    std::atomic<int32_t> queuedWorkerJobs{0};
+    std::atomic<int32_t> queuedMainThreadJobs{0};
+    std::atomic<uint32_t> nextWorker{0};
+    bool running = false;
+
+    // Index of the worker running on this thread, only valid when currentSystem is this
+    static thread_local JobSystem *currentSystem;
+    static thread_local uint32_t currentWorker;
+
+    void workerLoop(uint32_t index);
+    void enqueue(const JobHandle &job);
+    bool runOne();
+    void execute(const JobHandle &job);
+    void finish(const JobHandle &job);
+    void notifyWaiting();
+    [[nodiscard]] bool isMainThread() const { return std::this_thread::get_id() == mainThreadId; }
+};
+
+#endif  //STARTER_JOBS_H
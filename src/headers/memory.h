@@ -0,0 +1,85 @@
+#ifndef STARTER_MEMORY_H
+#define STARTER_MEMORY_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * Index of a memory type allowed by typeFilter that has all the requested property flags
+ *
+ * @param physicalDevice
+ * @param typeFilter
+ * @param properties
+ * @return
+ */
+inline uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("Failed to find suitable memory type!");
+}
+
+/**
+ * Allocate a dedicated block of memory for the image and bind it
+ *
+ * @param physicalDevice
+ * @param device
+ * @param image
+ * @param properties
+ * @return
+ */
+inline VkDeviceMemory allocateImageMemory(VkPhysicalDevice physicalDevice, VkDevice device, VkImage image,
+                                          VkMemoryPropertyFlags properties) {
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device, image, &requirements);
+
+    VkMemoryAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = requirements.size,
+            .memoryTypeIndex = findMemoryType(physicalDevice, requirements.memoryTypeBits, properties),
+    };
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(device, &allocInfo, VK_NULL_HANDLE, &memory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate image memory!");
+    }
+    vkBindImageMemory(device, image, memory, 0);
+    return memory;
+}
+
+/**
+ * Allocate a dedicated block of memory for the buffer and bind it
+ *
+ * @param physicalDevice
+ * @param device
+ * @param buffer
+ * @param properties
+ * @return
+ */
+inline VkDeviceMemory allocateBufferMemory(VkPhysicalDevice physicalDevice, VkDevice device, VkBuffer buffer,
+                                           VkMemoryPropertyFlags properties) {
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device, buffer, &requirements);
+
+    VkMemoryAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = requirements.size,
+            .memoryTypeIndex = findMemoryType(physicalDevice, requirements.memoryTypeBits, properties),
+    };
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(device, &allocInfo, VK_NULL_HANDLE, &memory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate buffer memory!");
+    }
+    vkBindBufferMemory(device, buffer, memory, 0);
+    return memory;
+}
+
+#endif  //STARTER_MEMORY_H
@@ -0,0 +1,136 @@
+#ifndef STARTER_MESH_H
+#define STARTER_MESH_H
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * Full precision vertex as produced by an importer, before any processing
+ */
+struct MeshVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 uv;
+    glm::vec4 color;
+};
+
+/**
+ * Bandwidth reduced vertex consumed by mesh.vert (20 bytes instead of 48)
+ *
+ * position: 16-bit unorm, relative to the mesh AABB (w is padding, R16G16B16 is rarely a supported vertex format)
+ * normal:   16-bit snorm, octahedral encoded
+ * uv:       half float
+ * color:    RGBA8 unorm
+ */
+struct PackedVertex {
+    uint16_t position[4];
+    int16_t normal[2];
+    uint16_t uv[2];
+    uint32_t color;
+
+    static VkVertexInputBindingDescription getBindingDescription() {
+        return {
+                .binding = 0,
+                .stride = sizeof(PackedVertex),
+                .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+        };
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions() {
+        return {{
+                {.location = 0, .binding = 0, .format = VK_FORMAT_R16G16B16A16_UNORM, .offset = 0},
+                {.location = 1, .binding = 0, .format = VK_FORMAT_R16G16_SNORM, .offset = 8},
+                {.location = 2, .binding = 0, .format = VK_FORMAT_R16G16_SFLOAT, .offset = 12},
+                {.location = 3, .binding = 0, .format = VK_FORMAT_R8G8B8A8_UNORM, .offset = 16},
+        }};
+    }
+};
+
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex layout must match the attribute offsets");
+
+/**
+ * Push constants used by mesh.vert to turn the unorm positions back into object space
+ * Must match the MeshDecode block in mesh.vert
+ */
+struct MeshDecodeConstants {
+    glm::vec4 positionScale;
+    glm::vec4 positionOffset;
+};
+
+struct QuantizedMesh {
+    std::vector<PackedVertex> vertices;
+    std::vector<uint32_t> indices;
+    MeshDecodeConstants decode{};
+};
+
+/**
+ * Import time mesh processing: cache / overdraw / fetch reordering followed by attribute quantization
+ */
+class MeshOptimizer {
+public:
+    // Size of the simulated post-transform cache used when reordering triangles
+    static constexpr uint32_t vertexCacheSize = 32;
+
+    /**
+     * Run the full import pipeline on an indexed triangle list
+     *
+     * @param vertices
+     * @param indices
+     * @return
+     */
+    static QuantizedMesh importMesh(std::vector<MeshVertex> vertices, std::vector<uint32_t> indices);
+
+    /**
+     * Reorder triangles to maximize post-transform cache hits (Forsyth, "Linear-Speed Vertex Cache Optimisation")
+     *
+     * @param indices
+     * @param vertexCount
+     */
+    static void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+
+    /**
+     * Reorder clusters of cache optimized triangles so that outward facing clusters are drawn first.
+     * Cluster boundaries are placed where the cache is cold, so the cache efficiency is mostly kept.
+     *
+     * @param indices
+     * @param vertices
+     */
+    static void optimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<MeshVertex> &vertices);
+
+    /**
+     * Reorder the vertex buffer in the order the index buffer first references each vertex.
+     * Unreferenced vertices are dropped.
+     *
+     * @param indices
+     * @param vertices
+     */
+    static void optimizeVertexFetch(std::vector<uint32_t> &indices, std::vector<MeshVertex> &vertices);
+
+    /**
+     * Compress the vertices into PackedVertex, positions are normalized against the mesh AABB
+     *
+     * @param vertices
+     * @param decode
+     * @return
+     */
+    static std::vector<PackedVertex> quantize(const std::vector<MeshVertex> &vertices, MeshDecodeConstants &decode);
+
+    /**
+     * Average Cache Miss Ratio of an index buffer for a FIFO cache of the given size (lower is better, 0.5 is ideal)
+     *
+     * @param indices
+     * @param vertexCount
+     * @param cacheSize
+     * @return
+     */
+    static float computeACMR(const std::vector<uint32_t> &indices, size_t vertexCount,
+                             uint32_t cacheSize = vertexCacheSize);
+
+private:
+    static glm::vec2 octahedralEncode(glm::vec3 normal);
+};
+
+#endif  //STARTER_MESH_H
@@ -0,0 +1,106 @@
+#ifndef STARTER_MULTIVIEW_H
+#define STARTER_MULTIVIEW_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "mesh.h"
+
+/**
+ * Renders the same scene from many viewpoints into the array layers of one offscreen image using VK_KHR_multiview
+ * (core in Vulkan 1.1). Each view reads its matrix from a storage buffer indexed by firstView + gl_ViewIndex.
+ *
+ * A render pass can broadcast to at most maxMultiviewViewCount views, so larger view counts are split into equally
+ * sized batches that each target their own range of layers. Padding layers at the end repeat the last view.
+ */
+class MultiviewRenderer {
+public:
+    // Must match the push constant block in multiview.vert
+    struct PushConstants {
+        MeshDecodeConstants decode;
+        uint32_t firstView;
+    };
+
+    // Records the scene for one batch, the layout is passed so meshes can push their MeshDecodeConstants
+    using DrawCallback = std::function<void(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout)>;
+
+    static constexpr VkFormat depthFormat = VK_FORMAT_D32_SFLOAT;
+
+    void create(VkPhysicalDevice physicalDevice, VkDevice device, VkFormat colorFormat, VkExtent2D extent,
+                uint32_t viewCount);
+    void destroy();
+
+    /**
+     * Build the graphics pipeline for multiview.vert with the PackedVertex layout.
+     * Shader modules are owned by the caller.
+     *
+     * @param vertShaderModule
+     * @param fragShaderModule
+     */
+    void createPipeline(VkShaderModule vertShaderModule, VkShaderModule fragShaderModule);
+
+    /**
+     * Upload one view-projection matrix per view, the buffer is persistently mapped so this is a plain copy
+     *
+     * @param viewProjections
+     */
+    void setViewMatrices(const std::vector<glm::mat4> &viewProjections);
+
+    /**
+     * Record every batch into the command buffer. After it executes the image is in TRANSFER_SRC_OPTIMAL.
+     *
+     * @param commandBuffer
+     * @param drawScene
+     */
+    void record(VkCommandBuffer commandBuffer, const DrawCallback &drawScene);
+
+    [[nodiscard]] VkImage getImage() const { return colorImage; }
+    [[nodiscard]] uint32_t getViewCount() const { return viewCount; }
+    [[nodiscard]] uint32_t getLayerCount() const { return batchCount * batchSize; }
+    [[nodiscard]] uint32_t getBatchCount() const { return batchCount; }
+    [[nodiscard]] uint32_t getBatchSize() const { return batchSize; }
+
+    static uint32_t queryMaxViewCount(VkPhysicalDevice physicalDevice);
+
+private:
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent{};
+    uint32_t viewCount = 0;
+    uint32_t batchCount = 0;
+    uint32_t batchSize = 0;
+
+    VkImage colorImage = VK_NULL_HANDLE;
+    VkDeviceMemory colorMemory = VK_NULL_HANDLE;
+    VkImage depthImage = VK_NULL_HANDLE;
+    VkDeviceMemory depthMemory = VK_NULL_HANDLE;
+    std::vector<VkImageView> colorViews;  // One per batch, covering the batch's layers
+    std::vector<VkImageView> depthViews;
+    std::vector<VkFramebuffer> framebuffers;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+
+    VkBuffer viewBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory viewMemory = VK_NULL_HANDLE;
+    glm::mat4 *mappedViews = nullptr;
+
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+
+    void createImages();
+    void createRenderPass();
+    void createFramebuffers();
+    void createViewBuffer();
+    void createDescriptors();
+
+    VkImage createLayeredImage(VkFormat format, VkImageUsageFlags usage, VkDeviceMemory &memory);
+    VkImageView createLayerView(VkImage image, VkFormat format, VkImageAspectFlags aspect, uint32_t baseLayer);
+};
+
+#endif  //STARTER_MULTIVIEW_H
@@ -0,0 +1,183 @@
+#ifndef STARTER_RESOLUTION_H
+#define STARTER_RESOLUTION_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * Picks the render scale for the next frame from measured GPU frame times.
+ *
+ * GPU cost is roughly proportional to the pixel count, so the scale needed to hit the budget is
+ * scale * sqrt(budget / time). The controller moves part of the way there each frame, ignores errors within a small
+ * dead band to avoid oscillating, and reacts immediately to spikes well over budget.
+ */
+class ResolutionController {
+public:
+    struct Settings {
+        float gpuBudgetMs = 1000.0f / 60.0f;
+        float minScale = 0.5f;
+        float maxScale = 1.0f;
+    };
+
+    // Fraction of the remaining error corrected per frame
+    static constexpr float gain = 0.25f;
+    // Relative error below which the scale is left alone
+    static constexpr float deadBand = 0.05f;
+    // Weight of the newest sample in the smoothed GPU time
+    static constexpr float smoothing = 0.2f;
+    // Frames over budget by more than this factor bypass the smoothing
+    static constexpr float spikeFactor = 1.5f;
+
+    void configure(const Settings &settings);
+
+    /**
+     * Feed the GPU time of a finished frame
+     *
+     * @param gpuTimeMs
+     * @return Scale to render the next frame at
+     */
+    float update(float gpuTimeMs);
+
+    [[nodiscard]] float getScale() const { return scale; }
+    [[nodiscard]] float getSmoothedGpuTimeMs() const { return smoothedGpuTimeMs; }
+    [[nodiscard]] const Settings &getSettings() const { return settings; }
+
+    /**
+     * Extent of the sub-rectangle to render into, never larger than the full extent or smaller than 1x1
+     *
+     * @param extent
+     * @param scale
+     * @return
+     */
+    static VkExtent2D scaleExtent(VkExtent2D extent, float scale);
+
+private:
+    Settings settings{};
+    float scale = 1.0f;
+    float smoothedGpuTimeMs = 0.0f;
+};
+
+/**
+ * Offscreen color and depth target allocated once at the maximum render size. Frames render into a sub-rectangle of
+ * it, so changing the resolution never reallocates, and the sub-rectangle is then blitted with filtering onto the
+ * swapchain. Also owns the timestamp queries that measure each frame's GPU time.
+ *
+ * When upscaling is off, or the formats cannot be blitted, frames render straight into the swapchain images instead,
+ * through a render pass that is compatible with the offscreen one so the same pipelines work for both. Both passes
+ * share the depth image, the offscreen color image is only allocated by createOffscreenFramebuffer().
+ */
+class ScaledRenderTarget {
+public:
+    // Pipelines drawn in the scene pass must use this format for their depth attachment
+    static constexpr VkFormat depthFormat = VK_FORMAT_D32_SFLOAT;
+
+    void create(VkPhysicalDevice physicalDevice, VkDevice device, VkFormat format, VkExtent2D maxExtent,
+                VkFormat swapChainFormat, uint32_t framesInFlight);
+    void destroy();
+
+    /**
+     * Allocate the color image at the maximum extent and its framebuffer, needed by beginScene() and
+     * endSceneAndUpscale(). Frames drawn only with beginDirectScene() never allocate it.
+     */
+    void createOffscreenFramebuffer();
+
+    /**
+     * Framebuffers for rendering directly into the swapchain with beginDirectScene(), needed when not upscaling
+     *
+     * @param swapChainImageViews Must have the format the target was created with
+     * @param swapChainExtent
+     */
+    void createSwapChainFramebuffers(const std::vector<VkImageView> &swapChainImageViews, VkExtent2D swapChainExtent);
+
+    /**
+     * Reset the frame's timestamps, begin the render pass on the sub-rectangle with color and depth cleared, and set
+     * the matching viewport/scissor
+     *
+     * @param commandBuffer
+     * @param frame Frame in flight index
+     * @param renderExtent
+     */
+    void beginScene(VkCommandBuffer commandBuffer, uint32_t frame, VkExtent2D renderExtent);
+
+    /**
+     * Same as beginScene, but renders the whole swapchain image at native resolution. End it with endScene(), the
+     * render pass leaves the image in PRESENT_SRC_KHR.
+     *
+     * @param commandBuffer
+     * @param frame Frame in flight index
+     * @param imageIndex Acquired swapchain image
+     */
+    void beginDirectScene(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t imageIndex);
+
+    /**
+     * End the render pass and blit the rendered sub-rectangle over the whole swapchain image, which is left in
+     * PRESENT_SRC_KHR. The measured GPU time ends before the blit, so it excludes waiting for the swapchain image.
+     *
+     * @param commandBuffer
+     * @param frame
+     * @param swapChainImage
+     * @param swapChainExtent
+     */
+    void endSceneAndUpscale(VkCommandBuffer commandBuffer, uint32_t frame, VkImage swapChainImage,
+                            VkExtent2D swapChainExtent);
+
+    /**
+     * End the render pass and write the end timestamp without a blit, for direct scenes and offscreen work such as
+     * benchmarks
+     *
+     * @param commandBuffer
+     * @param frame
+     */
+    void endScene(VkCommandBuffer commandBuffer, uint32_t frame);
+
+    /**
+     * GPU time of the last frame recorded with this frame index, only valid once its fence has been waited on
+     *
+     * @param frame
+     * @return
+     */
+    std::optional<float> readGpuTimeMs(uint32_t frame);
+
+    [[nodiscard]] VkRenderPass getRenderPass() const { return renderPass; }
+    [[nodiscard]] VkExtent2D getMaxExtent() const { return maxExtent; }
+    // The target format can be blitted onto the swapchain format
+    [[nodiscard]] bool isUpscaleSupported() const { return upscaleSupported; }
+
+private:
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkFormat swapChainFormat = VK_FORMAT_UNDEFINED;
+    VkExtent2D maxExtent{};
+    VkExtent2D renderExtent{};
+    VkFilter blitFilter = VK_FILTER_LINEAR;
+    bool upscaleSupported = false;
+
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView imageView = VK_NULL_HANDLE;
+    VkImage depthImage = VK_NULL_HANDLE;
+    VkDeviceMemory depthMemory = VK_NULL_HANDLE;
+    VkImageView depthImageView = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+    VkRenderPass swapChainRenderPass = VK_NULL_HANDLE;
+    std::vector<VkFramebuffer> swapChainFramebuffers;
+    VkExtent2D swapChainExtent{};
+
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    float timestampPeriodNs = 1.0f;
+    std::vector<bool> queriesWritten;  // Reading a query that was never written is invalid
+
+    void createImage();
+    void createDepthImage();
+    VkRenderPass createRenderPass(bool toSwapChain);
+    void createQueryPool(uint32_t framesInFlight);
+    void begin(VkCommandBuffer commandBuffer, uint32_t frame, VkRenderPass pass, VkFramebuffer target,
+               VkExtent2D extent);
+};
+
+#endif  //STARTER_RESOLUTION_H
@@ -0,0 +1,182 @@
+#ifndef STARTER_TEXTURE_H
+#define STARTER_TEXTURE_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "jobs.h"
+
+/**
+ * Streams texture mips in and out of device local memory.
+ *
+ * Textures start with only their coarse mips resident. Callers report how finely each texture is sampled on screen
+ * with requestMip(), and update() promotes textures one mip at a time while the device local heap stays under
+ * budget, evicting the finest mips of the least recently used textures when it does not.
+ *
+ * Without sparse residency a texture's mip range is changed by recreating its image with the new range. Levels that
+ * were already resident are copied from the old image on the GPU, so only a newly promoted mip goes through staging.
+ *
+ * Uploads are recorded into one of framesInFlight upload slots, each with a command buffer, a fence and a persistently
+ * mapped staging buffer, and submitted without waiting. A slot is reused framesInFlight updates later, by which time
+ * its fence has normally signaled. The fence also covers every frame submitted before it on the same queue, so images
+ * replaced during an update are destroyed when the slot comes around again.
+ */
+class TextureStreamer {
+public:
+    struct Stats {
+        VkDeviceSize residentBytes;
+        VkDeviceSize budgetBytes;
+        uint32_t pendingRequests;
+        uint64_t evictions;
+        float evictionRate;  // Evictions per update, exponentially smoothed
+    };
+
+    // Linear textures (normal maps, masks) are stored as UNORM, color textures as SRGB so sampling linearizes them
+    enum class ColorSpace : uint8_t { Srgb, Linear };
+
+    // Mips whose largest dimension is at most this many texels are always resident
+    static constexpr uint32_t coarseMipSize = 64;
+    // Fraction of the device local heap budget textures may use
+    static constexpr float budgetFraction = 0.8f;
+    // Upper bound on the bytes staged by a single update() to avoid hitches, also the size of each staging buffer
+    static constexpr VkDeviceSize maxUploadBytesPerUpdate = 32ull * 1024 * 1024;
+    // Textures requested within this many frames are still considered in use
+    static constexpr uint64_t recentUseFrames = 3;
+
+    /**
+     * @param physicalDevice
+     * @param device
+     * @param queue Queue the frames are rendered on, uploads are ordered before the next frame through it
+     * @param queueFamilyIndex
+     * @param memoryBudgetSupported VK_EXT_memory_budget is enabled, ignored on devices older than Vulkan 1.1
+     * @param budgetCapBytes Most memory textures may use even when the heap has more room, 0 for no cap
+     * @param framesInFlight Number of upload slots
+     */
+    void create(VkPhysicalDevice physicalDevice, VkDevice device, VkQueue queue, uint32_t queueFamilyIndex,
+                bool memoryBudgetSupported, VkDeviceSize budgetCapBytes, uint32_t framesInFlight);
+    void destroy();
+
+    /**
+     * Register a RGBA8 texture. The full mip chain is generated and kept on the CPU, its coarse mips are uploaded by
+     * the next update() and count against the budget like any other mip. Until then the texture has no image view.
+     *
+     * @param width
+     * @param height
+     * @param pixels
+     * @param colorSpace Color space of the RGB channels, alpha is always linear
+     * @return Texture id
+     */
+    uint32_t addTexture(uint32_t width, uint32_t height, std::vector<uint8_t> pixels, ColorSpace colorSpace);
+
+    /**
+     * Same as addTexture, but the mip chain is generated on a worker and the texture is registered by a main thread
+     * job, since the streamer itself is not thread safe
+     *
+     * @param jobSystem
+     * @param width
+     * @param height
+     * @param pixels
+     * @param colorSpace
+     * @param onLoaded Receives the texture id on the main thread
+     * @return Handle of the registration job
+     */
+    JobSystem::JobHandle addTextureAsync(JobSystem &jobSystem, uint32_t width, uint32_t height,
+                                         std::vector<uint8_t> pixels, ColorSpace colorSpace,
+                                         std::function<void(uint32_t)> onLoaded);
+
+    /**
+     * Screen space usage feedback, marks the texture as used this frame and asks for the given mip to be resident
+     *
+     * @param texture
+     * @param mip
+     */
+    void requestMip(uint32_t texture, uint32_t mip);
+
+    /**
+     * Process pending requests and evictions and submit the uploads, must be called once per frame before the frame
+     * is submitted to the same queue. Nothing is submitted when residency does not change.
+     *
+     * @param frameIndex
+     */
+    void update(uint64_t frameIndex);
+
+    [[nodiscard]] VkImageView getImageView(uint32_t texture) const { return textures[texture].view; }
+    [[nodiscard]] Stats getStats() const;
+
+    /**
+     * Mip level needed for a texture covering screenPixels pixels along its largest dimension
+     *
+     * @param width
+     * @param height
+     * @param screenPixels
+     * @return
+     */
+    static uint32_t mipForScreenCoverage(uint32_t width, uint32_t height, float screenPixels);
+
+private:
+    struct StreamedTexture {
+        uint32_t width;
+        uint32_t height;
+        uint32_t coarseMip;  // Finest mip that is never evicted
+        VkFormat format;
+        std::vector<std::vector<uint8_t>> mips;
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t residentMip = 0;  // Finest mip currently on the GPU, mip count when nothing is resident yet
+        uint32_t requestedMip = 0;
+        uint64_t lastUsedFrame = 0;
+        VkDeviceSize residentBytes = 0;
+    };
+
+    struct RetiredImage {
+        VkImage image;
+        VkDeviceMemory memory;
+        VkImageView view;
+    };
+
+    struct UploadSlot {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;  // Signaled once the slot's uploads and every earlier frame completed
+        VkBuffer stagingBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+        VkDeviceSize stagingSize = 0;
+        void *mapped = VK_NULL_HANDLE;
+        std::vector<RetiredImage> retiredImages;  // Replaced during the slot's last update
+    };
+
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    bool memoryBudgetSupported = false;
+    bool memoryProperties2Supported = false;
+    VkDeviceSize budgetCapBytes = 0;
+
+    std::vector<StreamedTexture> textures;
+    std::vector<UploadSlot> uploadSlots;
+    uint32_t currentSlot = 0;
+    uint64_t currentFrame = 0;
+    VkDeviceSize residentBytes = 0;
+    VkDeviceSize budgetBytes = 0;
+    uint64_t evictions = 0;
+    float evictionRate = 0.0f;
+
+    [[nodiscard]] VkDeviceSize queryBudget() const;
+    uint32_t registerTexture(uint32_t width, uint32_t height, std::vector<std::vector<uint8_t>> mips,
+                             ColorSpace colorSpace);
+    void makeResident(std::vector<uint32_t> &textureIds, std::vector<uint32_t> &targetMips);
+    void retire(StreamedTexture &texture);
+    void reserveStaging(UploadSlot &slot, VkDeviceSize size);
+    void destroyRetired(UploadSlot &slot);
+
+    static VkDeviceSize mipRangeBytes(const StreamedTexture &texture, uint32_t firstMip, uint32_t lastMip);
+    static std::vector<std::vector<uint8_t>> generateMips(uint32_t width, uint32_t height, std::vector<uint8_t> pixels,
+                                                          ColorSpace colorSpace);
+    static float srgbToLinear(uint8_t value);
+    static uint8_t linearToSrgb(float value);
+};
+
+#endif  //STARTER_TEXTURE_H
@@ -3,6 +3,7 @@
 #include <GLFW/glfw3.h>
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
+#include <chrono>
 #include <format>
 #include <fstream>
 #include <iomanip>
@@ -11,18 +12,30 @@
 #include <set>
 #include <vector>
 
+#include "descriptors.h"
+#include "drawlist.h"
+#include "jobs.h"
+#include "mesh.h"
+#include "multiview.h"
+#include "resolution.h"
+#include "texture.h"
+#include "uniforms.h"
+
 #ifndef STARTER_TRIANGLE_H
 #define STARTER_TRIANGLE_H
 
 
 class VulkanStarterTriangle {
 public:
-    VulkanStarterTriangle(int width, int height);
+    VulkanStarterTriangle(int width, int height, uint32_t viewCount, float gpuBudgetMs, uint32_t benchmarkDrawCount);
     void run();
 
 private:
     int width;
     int height;
+    uint32_t viewCount;  // 0 renders to the swapchain, otherwise to the layers of an offscreen multiview target
+    float gpuBudgetMs;   // 0 keeps the render scale fixed at 1
+    uint32_t benchmarkDrawCount;  // Non zero replaces the main loop with the draw list benchmark
     GLFWwindow *window;
     VkInstance instance;
     VkDebugUtilsMessengerEXT debugMessenger;
@@ -37,7 +50,101 @@ private:
     std::vector<VkImage> swapChainImages;
     VkFormat swapChainImageFormat;
     VkExtent2D swapChainExtent{};
+    VkExtent2D framebufferExtent{};  // Queried in initWindow, GLFW window functions are main thread only
     std::vector<VkImageView> swapChainImageViews;
+    bool swapChainBlitSupported;  // Swapchain images can be created as transfer destinations
+    bool upscaleEnabled;          // Frames render scaled and are blitted, otherwise straight into the swapchain
+    bool memoryBudgetSupported;
+    JobSystem jobSystem;
+    std::vector<char> vertShaderCode;
+    std::vector<char> fragShaderCode;
+    std::vector<char> meshVertShaderCode;
+    std::vector<char> meshFragShaderCode;
+    std::vector<char> multiviewVertShaderCode;  // Only loaded when rendering multiview
+    TextureStreamer textureStreamer;
+    std::vector<uint32_t> meshTextures;  // Streamed textures cycled on the demo mesh, appended as they finish loading
+    MultiviewRenderer multiviewRenderer;
+    VkCommandPool commandPool;
+    ResolutionController resolutionController;
+    ScaledRenderTarget scaledRenderTarget;
+    VkPipelineLayout pipelineLayout;
+    VkPipeline opaquePipeline;
+    VkPipeline transparentPipeline;
+    std::vector<VkCommandBuffer> commandBuffers;
+    std::vector<VkSemaphore> imageAvailableSemaphores;
+    std::vector<VkSemaphore> renderFinishedSemaphores;
+    std::vector<VkFence> inFlightFences;
+    UniformRingBuffer objectRing;  // Storage buffer holding every draw's transform
+    DescriptorAllocator descriptorAllocator;
+    VkDescriptorSetLayout objectSetLayout;
+    VkDescriptorSet objectSet;  // Written once, each frame's object block is selected with a dynamic offset
+    uint32_t objectCapacity;    // Transforms per frame, enough for the scene or the benchmark
+    VkDescriptorSetLayout materialSetLayout;
+    VkBuffer materialBuffer;
+    VkDeviceMemory materialMemory;
+    std::vector<VkDescriptorSet> materialSets;
+    DrawList drawList;
+    uint32_t triangleMesh;
+    DrawList::BindStats lastBindStats{};
+    VkDescriptorSetLayout meshTextureSetLayout;
+    VkSampler meshTextureSampler;
+    VkPipelineLayout meshPipelineLayout;
+    VkPipeline meshPipeline;
+    VkBuffer meshVertexBuffer;
+    VkDeviceMemory meshVertexMemory;
+    VkBuffer meshIndexBuffer;
+    VkDeviceMemory meshIndexMemory;
+    uint32_t meshIndexCount;
+    MeshDecodeConstants meshDecode{};
+    uint32_t currentFrame;
+    float lastGpuTimeMs;
+    uint64_t frameIndex;
+    std::chrono::steady_clock::time_point lastStatsTime;
+
+    // How often the frame statistics table is printed
+    static constexpr std::chrono::seconds statsInterval{5};
+    static constexpr uint32_t maxFramesInFlight = 2;
+
+    static constexpr uint32_t materialCount = 64;
+    static constexpr uint32_t sceneObjectCount = 256;
+    static constexpr uint32_t benchmarkPipelineCount = 8;
+    static constexpr uint32_t benchmarkIterations = 10;
+
+    static constexpr float demoMeshRadius = 0.3f;  // In clip space
+    // The cap keeps only a few of the mesh textures resident at the mip the mesh needs, so the ones it stopped
+    // showing are evicted as the next ones stream in
+    static constexpr uint32_t meshTextureCount = 4;
+    static constexpr uint32_t meshTextureSize = 2048;
+    static constexpr uint64_t meshTextureFrames = 120;  // Frames each mesh texture is shown for
+    static constexpr VkDeviceSize textureBudgetCapBytes = 4 * 1024 * 1024;
+
+    // Must match the uniform block in shader.vert
+    struct MaterialUniforms {
+        glm::vec4 tint;
+    };
+
+    struct SceneObject {
+        glm::vec3 position;  // z doubles as the sort depth and the depth buffer value
+        float scale;
+        float spin;  // Radians per frame
+        uint32_t pipeline;
+        uint32_t material;
+        DrawList::Pass pass;
+    };
+
+    std::vector<SceneObject> sceneObjects;
+
+    // Filled by createDemoMesh on a worker, printed on the main thread once startup has finished
+    struct MeshImportStats {
+        size_t vertices;
+        uint32_t triangles;
+        float acmrBefore;
+        float acmrAfter;
+        size_t vertexBytesBefore;
+        size_t vertexBytesAfter;
+    };
+
+    MeshImportStats meshImportStats{};
 
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphicsFamily;
@@ -64,11 +171,35 @@ private:
     void createSurface();
     void createSwapChain();
     void createImageViews();
+    void loadShaders();
     void createGraphicsPipeline();
+    VkPipeline createScenePipeline(bool transparent);
+    VkPipeline createPipeline(const std::vector<char> &vertCode, const std::vector<char> &fragCode,
+                              VkPipelineLayout layout, const VkPipelineVertexInputStateCreateInfo &vertexInput,
+                              bool transparent);
+    void createDemoMesh();
+    void createMeshPipeline();
+    void createMaterials();
+    void createScene();
+    uint32_t buildDrawList();  // Returns the dynamic offset of the frame's object block
+    void benchmarkDrawList();
+    void createTextureStreamer();
+    void loadMeshTextures();
+    void drawDemoMesh(VkCommandBuffer commandBuffer, VkExtent2D renderExtent);
+    void createCommandPool();
+    void createScaledRenderTarget();
+    void createFrameResources();
+    void createFrameUniforms();
+    void drawFrame();
+    void createMultiviewRenderer();
+    void printStartupStats();
+    void renderMultiview();
+    void printFrameStats();
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice pDevice);
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice pDevice);
     bool isDeviceSuitable(VkPhysicalDevice pDevice);
     bool checkDeviceExtensionSupport(VkPhysicalDevice pDevice);
+    static bool isDeviceExtensionSupported(VkPhysicalDevice pDevice, const char *extensionName);
     VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities);
     VkShaderModule createShaderModule(const std::vector<char> &code);
 
@@ -0,0 +1,78 @@
+#ifndef STARTER_UNIFORMS_H
+#define STARTER_UNIFORMS_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+/**
+ * Persistently mapped uniform or storage buffer split into one region per frame in flight. Each frame bump allocates
+ * chunks aligned to the device's minimum dynamic offset alignment from its own region, and the region is rewound once
+ * the frame's fence has been waited on, so per-draw data costs a pointer bump and a memcpy.
+ *
+ * The buffer is meant to be bound once through a UNIFORM_BUFFER_DYNAMIC or STORAGE_BUFFER_DYNAMIC descriptor of
+ * getRange() bytes, every chunk is then selected with the dynamic offset returned by allocate().
+ */
+class UniformRingBuffer {
+public:
+    struct Allocation {
+        void *data;
+        uint32_t dynamicOffset;
+    };
+
+    struct Stats {
+        VkDeviceSize usedBytes;      // Current frame
+        VkDeviceSize peakBytes;      // Highest usage of any frame so far
+        VkDeviceSize capacityBytes;  // Per frame
+    };
+
+    /**
+     * @param physicalDevice
+     * @param device
+     * @param bytesPerFrame Size of each frame's region
+     * @param range Largest block a single allocation may hold, the range of the dynamic descriptor
+     * @param framesInFlight
+     * @param usage VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT or VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, selects the alignment and
+     * range limits that apply
+     */
+    void create(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize bytesPerFrame, VkDeviceSize range,
+                uint32_t framesInFlight, VkBufferUsageFlags usage);
+    void destroy();
+
+    /**
+     * Rewind the frame's region, the GPU must be done with the last frame that used this index
+     *
+     * @param frame Frame in flight index
+     */
+    void beginFrame(uint32_t frame);
+
+    /**
+     * Reserve an aligned chunk of the current frame's region. Throws when the region is exhausted.
+     *
+     * @param size At most getRange()
+     * @return
+     */
+    Allocation allocate(VkDeviceSize size);
+
+    [[nodiscard]] VkBuffer getBuffer() const { return buffer; }
+    [[nodiscard]] VkDeviceSize getRange() const { return range; }
+    [[nodiscard]] Stats getStats() const { return {offset - regionBegin, peakBytes, regionSize}; }
+
+private:
+    VkDevice device = VK_NULL_HANDLE;
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    uint8_t *mapped = nullptr;
+
+    VkDeviceSize alignment = 1;
+    VkDeviceSize range = 0;
+    VkDeviceSize regionSize = 0;
+    VkDeviceSize regionBegin = 0;
+    VkDeviceSize offset = 0;
+    VkDeviceSize peakBytes = 0;
+
+    static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+};
+
+#endif  //STARTER_UNIFORMS_H
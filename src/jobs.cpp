@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <chrono>
+
+#include "headers/jobs.h"
+
+thread_local JobSystem *JobSystem::currentSystem = nullptr;
+thread_local uint32_t JobSystem::currentWorker = 0;
+
+// Public
+void JobSystem::create(uint32_t workerCount) {
+    mainThreadId = std::this_thread::get_id();
+    running = true;
+
+    for (uint32_t i = 0; i < workerCount; i++) { workers.push_back(std::make_unique<Worker>()); }
+    // Threads start only once every deque exists, they steal from each other right away
+    for (uint32_t i = 0; i < workerCount; i++) { workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i); }
+}
+
+void JobSystem::destroy() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        if (!running) { return; }
+        running = false;
+    }
+    wakeCondition.notify_all();
+
+    for (auto &worker: workers) { worker->thread.join(); }
+    workers.clear();
+    mainThreadJobs.clear();
+}
+
+JobSystem::JobHandle JobSystem::schedule(std::function<void()> task, const std::vector<JobHandle> &dependencies,
+                                         Affinity affinity) {
+    auto job = std::make_shared<Job>();
+    job->task = std::move(task);
+    job->affinity = affinity;
+
+    // The extra count keeps the job from being enqueued while its dependencies are still being registered
+    job->pendingDependencies.store(static_cast<uint32_t>(dependencies.size()) + 1);
+
+    for (const auto &dependency: dependencies) {
+        {
+            std::lock_guard<std::mutex> lock(dependency->mutex);
+            if (!dependency->done) {
+                dependency->continuations.push_back(job);
+                continue;
+            }
+        }
+
+        if (dependency->error) {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (!job->error) { job->error = dependency->error; }
+        }
+        job->pendingDependencies.fetch_sub(1);
+    }
+
+    if (job->pendingDependencies.fetch_sub(1) == 1) { enqueue(job); }
+    return job;
+}
+
+void JobSystem::wait(const JobHandle &job) {
+    while (!job->done.load(std::memory_order_acquire)) {
+        if (runOne()) { continue; }
+
+        // Nothing to help with, the job is running elsewhere. The timeout covers work queued for the main thread.
+        waitingThreads.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            doneCondition.wait_for(lock, std::chrono::milliseconds(1),
+                                   [&]() { return job->done.load() || queuedWorkerJobs.load() > 0 ||
+                                                  (isMainThread() && queuedMainThreadJobs.load() > 0); });
+        }
+        waitingThreads.fetch_sub(1);
+    }
+
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (job->error) { std::rethrow_exception(job->error); }
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t grainSize,
+                            const std::function<void(uint32_t, uint32_t)> &body) {
+    grainSize = std::max(grainSize, 1u);
+
+    // Chunks share their own copy, so the ones already scheduled stay valid if scheduling a later one throws
+    auto sharedBody = std::make_shared<const std::function<void(uint32_t, uint32_t)>>(body);
+
+    std::vector<JobHandle> chunks;
+    chunks.reserve((count + grainSize - 1) / grainSize);
+    for (uint32_t begin = 0; begin < count; begin += grainSize) {
+        uint32_t end = std::min(begin + grainSize, count);
+        chunks.push_back(schedule([sharedBody, begin, end]() { (*sharedBody)(begin, end); }));
+    }
+
+    // The body usually captures the caller's state by reference, so every chunk has to be finished before returning,
+    // even when an earlier one failed. The first error is rethrown once they are.
+    std::exception_ptr error;
+    for (const auto &chunk: chunks) {
+        try {
+            wait(chunk);
+        } catch (...) {
+            if (!error) { error = std::current_exception(); }
+        }
+    }
+    if (error) { std::rethrow_exception(error); }
+}
+
+void JobSystem::runMainThreadJobs() {
+    while (true) {
+        JobHandle job;
+        {
+            std::lock_guard<std::mutex> lock(mainThreadMutex);
+            if (mainThreadJobs.empty()) { return; }
+            job = std::move(mainThreadJobs.front());
+            mainThreadJobs.pop_front();
+        }
+        queuedMainThreadJobs.fetch_sub(1);
+        execute(job);
+    }
+}
+
+
+// Private
+void JobSystem::workerLoop(uint32_t index) {
+    currentSystem = this;
+    currentWorker = index;
+
+    while (true) {
+        if (runOne()) { continue; }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this]() { return !running || queuedWorkerJobs.load() > 0; });
+        if (!running) { return; }
+    }
+}
+
+void JobSystem::enqueue(const JobHandle &job) {
+    if (job->affinity == Affinity::MainThread || workers.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mainThreadMutex);
+            mainThreadJobs.push_back(job);
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queuedMainThreadJobs.fetch_add(1);
+        }
+        notifyWaiting();
+        return;
+    }
+
+    // Workers keep their own continuations local, other threads spread jobs round robin
+    uint32_t target = (currentSystem == this) ? currentWorker
+                                               : nextWorker.fetch_add(1) % static_cast<uint32_t>(workers.size());
+    {
+        std::lock_guard<std::mutex> lock(workers[target]->mutex);
+        workers[target]->jobs.push_back(job);
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedWorkerJobs.fetch_add(1);
+    }
+    wakeCondition.notify_one();
+    notifyWaiting();
+}
+
+bool JobSystem::runOne() {
+    JobHandle job;
+
+    if (isMainThread()) {
+        std::lock_guard<std::mutex> lock(mainThreadMutex);
+        if (!mainThreadJobs.empty()) {
+            job = std::move(mainThreadJobs.front());
+            mainThreadJobs.pop_front();
+        }
+    }
+    if (job) {
+        queuedMainThreadJobs.fetch_sub(1);
+        execute(job);
+        return true;
+    }
+
+    const auto workerCount = static_cast<uint32_t>(workers.size());
+    const bool isWorker = currentSystem == this;
+
+    // Own deque from the back first
+    if (isWorker) {
+        Worker &self = *workers[currentWorker];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        if (!self.jobs.empty()) {
+            job = std::move(self.jobs.back());
+            self.jobs.pop_back();
+        }
+    }
+
+    // Then steal the oldest job of another worker, starting next to ourselves to spread contention
+    for (uint32_t offset = 1; !job && offset <= workerCount; offset++) {
+        Worker &victim = *workers[((isWorker ? currentWorker : 0) + offset) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+        }
+    }
+
+    if (!job) { return false; }
+
+    queuedWorkerJobs.fetch_sub(1);
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(const JobHandle &job) {
+    bool failed;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        failed = static_cast<bool>(job->error);
+    }
+
+    if (!failed) {
+        try {
+            job->task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->error = std::current_exception();
+        }
+    }
+
+    finish(job);
+}
+
+void JobSystem::finish(const JobHandle &job) {
+    std::vector<JobHandle> continuations;
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->task = nullptr;  // Release captured state as soon as possible
+        continuations.swap(job->continuations);
+        error = job->error;
+        job->done.store(true, std::memory_order_release);
+    }
+
+    for (const auto &next: continuations) {
+        if (error) {
+            std::lock_guard<std::mutex> lock(next->mutex);
+            if (!next->error) { next->error = error; }
+        }
+        if (next->pendingDependencies.fetch_sub(1) == 1) { enqueue(next); }
+    }
+
+    notifyWaiting();
+}
+
+void JobSystem::notifyWaiting() {
+    if (waitingThreads.load() == 0) { return; }
+
+    // Taking the lock orders this with the predicate check of a thread about to sleep
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    doneCondition.notify_all();
+}
@@ -1,6 +1,8 @@
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 
 #include "headers/triangle.h"
 
@@ -8,10 +10,63 @@
 const int WIDTH = 800;
 const int HEIGHT = 600;
 
-int main() {
-    VulkanStarterTriangle app(WIDTH, HEIGHT);
+// Layers are rounded up to whole multiview passes, this keeps them under the 256 array layers every device supports
+const uint32_t MAX_VIEWS = 128;
+const uint32_t MAX_BENCHMARK_DRAWS = 1u << 20;
+const float MAX_GPU_BUDGET_MS = 1000.0f;
 
+// Whole string must be a number in [1, max], stoul alone accepts "12abc" and wraps "-1" around
+static uint32_t parseCount(const std::string &option, const std::string &value, uint32_t max) {
+    size_t parsed = 0;
+    unsigned long count = 0;
     try {
+        count = std::stoul(value, &parsed);
+    } catch (const std::exception &) { parsed = 0; }
+
+    if (parsed == 0 || parsed != value.size() || value.front() == '-' || count == 0 || count > max) {
+        throw std::runtime_error(option + " expects a whole number from 1 to " + std::to_string(max) + ", got '" +
+                                 value + "'!");
+    }
+    return static_cast<uint32_t>(count);
+}
+
+static float parseMilliseconds(const std::string &option, const std::string &value, float max) {
+    size_t parsed = 0;
+    float milliseconds = 0.0f;
+    try {
+        milliseconds = std::stof(value, &parsed);
+    } catch (const std::exception &) { parsed = 0; }
+
+    if (parsed == 0 || parsed != value.size() || !std::isfinite(milliseconds) || milliseconds <= 0.0f ||
+        milliseconds > max) {
+        throw std::runtime_error(option + " expects milliseconds greater than 0 and at most " +
+                                 std::to_string(static_cast<int>(max)) + ", got '" + value + "'!");
+    }
+    return milliseconds;
+}
+
+int main(int argc, char **argv) {
+    try {
+        // --views N renders N viewpoints per frame into a layered offscreen target instead of the swapchain
+        uint32_t viewCount = 0;
+        // --gpu-budget-ms X scales the render resolution each frame to keep the GPU frame time under X milliseconds
+        float gpuBudgetMs = 0.0f;
+        // --bench-drawlist N records N draws sorted and unsorted, prints bind counts and timings, then exits
+        uint32_t benchmarkDrawCount = 0;
+        for (int i = 1; i < argc; i++) {
+            const std::string option = argv[i];
+            if (option != "--views" && option != "--gpu-budget-ms" && option != "--bench-drawlist") {
+                throw std::runtime_error("Unknown option '" + option + "'!");
+            }
+            if (i + 1 >= argc) { throw std::runtime_error(option + " expects a value!"); }
+
+            const std::string value = argv[++i];
+            if (option == "--views") { viewCount = parseCount(option, value, MAX_VIEWS); }
+            if (option == "--gpu-budget-ms") { gpuBudgetMs = parseMilliseconds(option, value, MAX_GPU_BUDGET_MS); }
+            if (option == "--bench-drawlist") { benchmarkDrawCount = parseCount(option, value, MAX_BENCHMARK_DRAWS); }
+        }
+
+        VulkanStarterTriangle app(WIDTH, HEIGHT, viewCount, gpuBudgetMs, benchmarkDrawCount);
         app.run();
     } catch (const std::exception &e) {
         std::cerr << e.what() << std::endl;
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "headers/mesh.h"
+
+QuantizedMesh MeshOptimizer::importMesh(std::vector<MeshVertex> vertices, std::vector<uint32_t> indices) {
+    if (indices.size() % 3 != 0) { throw std::runtime_error("Mesh index count must be a multiple of 3!"); }
+    for (uint32_t index: indices) {
+        if (index >= vertices.size()) { throw std::runtime_error("Mesh index out of range!"); }
+    }
+
+    // Order matters: overdraw clusters are built on top of the cache order, and the fetch remap must be last
+    optimizeVertexCache(indices, vertices.size());
+    optimizeOverdraw(indices, vertices);
+    optimizeVertexFetch(indices, vertices);
+
+    QuantizedMesh mesh;
+    mesh.vertices = quantize(vertices, mesh.decode);
+    mesh.indices = std::move(indices);
+    return mesh;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) { return; }
+
+    // Scoring constants from the original paper
+    constexpr float cacheDecayPower = 1.5f;
+    constexpr float lastTriScore = 0.75f;
+    constexpr float valenceBoostScale = 2.0f;
+    constexpr float valenceBoostPower = 0.5f;
+
+    struct VertexData {
+        int32_t cachePosition = -1;
+        uint32_t remainingTriangles = 0;
+        uint32_t adjacencyOffset = 0;
+        float score = 0.0f;
+    };
+
+    auto vertexScore = [&](const VertexData &vertex) {
+        if (vertex.remainingTriangles == 0) { return -1.0f; }
+
+        float score = 0.0f;
+        if (vertex.cachePosition >= 0) {
+            if (vertex.cachePosition < 3) {
+                // The last triangle's vertices get a fixed score so the next one is not picked purely on them
+                score = lastTriScore;
+            } else {
+                const float scaler = 1.0f / static_cast<float>(vertexCacheSize - 3);
+                score = std::pow(1.0f - static_cast<float>(vertex.cachePosition - 3) * scaler, cacheDecayPower);
+            }
+        }
+
+        // Favour vertices with few triangles left so they are finished off and leave the cache
+        score += valenceBoostScale *
+                 std::pow(static_cast<float>(vertex.remainingTriangles), -valenceBoostPower);
+        return score;
+    };
+
+    // Build vertex -> triangle adjacency as a flat CSR list
+    std::vector<VertexData> vertexData(vertexCount);
+    for (uint32_t index: indices) { vertexData[index].remainingTriangles++; }
+
+    uint32_t offset = 0;
+    for (auto &vertex: vertexData) {
+        vertex.adjacencyOffset = offset;
+        offset += vertex.remainingTriangles;
+    }
+
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> adjacencyFill(vertexCount, 0);
+    for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+        for (size_t corner = 0; corner < 3; corner++) {
+            uint32_t vertex = indices[triangle * 3 + corner];
+            adjacency[vertexData[vertex].adjacencyOffset + adjacencyFill[vertex]++] = static_cast<uint32_t>(triangle);
+        }
+    }
+
+    for (auto &vertex: vertexData) { vertex.score = vertexScore(vertex); }
+
+    std::vector<bool> emitted(triangleCount, false);
+
+    // Cache holds vertexCacheSize entries plus room for the 3 vertices pushed before the tail is dropped
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> nextCache;
+    cache.reserve(vertexCacheSize + 3);
+    nextCache.reserve(vertexCacheSize + 3);
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    size_t linearCursor = 0;
+    size_t bestTriangle = std::numeric_limits<size_t>::max();
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (bestTriangle == std::numeric_limits<size_t>::max()) {
+            // Nothing in the cache is adjacent to anything left, restart from the next unused triangle
+            while (emitted[linearCursor]) { linearCursor++; }
+            bestTriangle = linearCursor;
+        }
+
+        emitted[bestTriangle] = true;
+        nextCache.clear();
+        for (size_t corner = 0; corner < 3; corner++) {
+            uint32_t vertex = indices[bestTriangle * 3 + corner];
+            output.push_back(vertex);
+            nextCache.push_back(vertex);
+
+            // Remove the triangle from the vertex's adjacency so its valence drops
+            VertexData &data = vertexData[vertex];
+            uint32_t *begin = adjacency.data() + data.adjacencyOffset;
+            uint32_t *end = begin + data.remainingTriangles;
+            std::iter_swap(std::find(begin, end, static_cast<uint32_t>(bestTriangle)), end - 1);
+            data.remainingTriangles--;
+        }
+
+        for (uint32_t vertex: cache) {
+            if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end()) {
+                nextCache.push_back(vertex);
+            }
+        }
+
+        // Vertices that fell out of the cache only lose their cache score
+        for (size_t i = vertexCacheSize; i < nextCache.size(); i++) {
+            vertexData[nextCache[i]].cachePosition = -1;
+            vertexData[nextCache[i]].score = vertexScore(vertexData[nextCache[i]]);
+        }
+        if (nextCache.size() > vertexCacheSize) { nextCache.resize(vertexCacheSize); }
+        std::swap(cache, nextCache);
+
+        for (size_t i = 0; i < cache.size(); i++) {
+            vertexData[cache[i]].cachePosition = static_cast<int32_t>(i);
+            vertexData[cache[i]].score = vertexScore(vertexData[cache[i]]);
+        }
+
+        // Only triangles touching the cache changed score, so the next candidate is searched among them
+        float bestScore = -1.0f;
+        bestTriangle = std::numeric_limits<size_t>::max();
+        for (uint32_t vertex: cache) {
+            const VertexData &data = vertexData[vertex];
+            for (uint32_t i = 0; i < data.remainingTriangles; i++) {
+                uint32_t triangle = adjacency[data.adjacencyOffset + i];
+                float score = vertexData[indices[triangle * 3 + 0]].score +
+                              vertexData[indices[triangle * 3 + 1]].score +
+                              vertexData[indices[triangle * 3 + 2]].score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = triangle;
+                }
+            }
+        }
+    }
+
+    indices = std::move(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<MeshVertex> &vertices) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) { return; }
+
+    // Split into clusters at "hard" boundaries: triangles whose 3 vertices all miss a simulated FIFO cache.
+    // Reordering whole clusters there costs almost nothing in vertex cache efficiency.
+    // Same cache size optimizeVertexCache targets, otherwise clusters split where that order is still warm
+    std::vector<uint32_t> timestamps(vertices.size(), 0);
+    uint32_t time = vertexCacheSize + 1;
+
+    std::vector<size_t> clusterStarts;
+    for (size_t triangle = 0; triangle < triangleCount; triangle++) {
+        uint32_t misses = 0;
+        for (size_t corner = 0; corner < 3; corner++) {
+            uint32_t vertex = indices[triangle * 3 + corner];
+            if (time - timestamps[vertex] > vertexCacheSize) {
+                timestamps[vertex] = time++;
+                misses++;
+            }
+        }
+        if (triangle == 0 || misses == 3) { clusterStarts.push_back(triangle); }
+    }
+
+    glm::vec3 meshCentroid(0.0f);
+    for (uint32_t index: indices) { meshCentroid += vertices[index].position; }
+    meshCentroid /= static_cast<float>(indices.size());
+
+    struct Cluster {
+        size_t begin;
+        size_t end;
+        float sortKey;
+    };
+
+    std::vector<Cluster> clusters(clusterStarts.size());
+    for (size_t i = 0; i < clusterStarts.size(); i++) {
+        Cluster &cluster = clusters[i];
+        cluster.begin = clusterStarts[i];
+        cluster.end = (i + 1 < clusterStarts.size()) ? clusterStarts[i + 1] : triangleCount;
+
+        glm::vec3 centroid(0.0f);
+        glm::vec3 normal(0.0f);
+        float weight = 0.0f;
+        for (size_t triangle = cluster.begin; triangle < cluster.end; triangle++) {
+            const glm::vec3 &p0 = vertices[indices[triangle * 3 + 0]].position;
+            const glm::vec3 &p1 = vertices[indices[triangle * 3 + 1]].position;
+            const glm::vec3 &p2 = vertices[indices[triangle * 3 + 2]].position;
+
+            // Area weighted, the cross product length is twice the area
+            glm::vec3 areaNormal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(areaNormal);
+            centroid += (p0 + p1 + p2) * (area / 3.0f);
+            normal += areaNormal;
+            weight += area;
+        }
+
+        float normalLength = glm::length(normal);
+        centroid = weight > 0.0f ? centroid / weight : vertices[indices[cluster.begin * 3]].position;
+        normal = normalLength > 0.0f ? normal / normalLength : glm::vec3(0.0f);
+
+        // Clusters far out along their own normal are likely occluders of the rest of the mesh
+        cluster.sortKey = glm::dot(centroid - meshCentroid, normal);
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster &a, const Cluster &b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (const auto &cluster: clusters) {
+        output.insert(output.end(), indices.begin() + static_cast<ptrdiff_t>(cluster.begin * 3),
+                      indices.begin() + static_cast<ptrdiff_t>(cluster.end * 3));
+    }
+    indices = std::move(output);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<uint32_t> &indices, std::vector<MeshVertex> &vertices) {
+    constexpr uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(vertices.size(), unassigned);
+    std::vector<MeshVertex> output;
+    output.reserve(vertices.size());
+
+    for (uint32_t &index: indices) {
+        if (remap[index] == unassigned) {
+            remap[index] = static_cast<uint32_t>(output.size());
+            output.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices = std::move(output);
+}
+
+std::vector<PackedVertex> MeshOptimizer::quantize(const std::vector<MeshVertex> &vertices,
+                                                  MeshDecodeConstants &decode) {
+    glm::vec3 aabbMin(std::numeric_limits<float>::max());
+    glm::vec3 aabbMax(std::numeric_limits<float>::lowest());
+    for (const auto &vertex: vertices) {
+        aabbMin = glm::min(aabbMin, vertex.position);
+        aabbMax = glm::max(aabbMax, vertex.position);
+    }
+    if (vertices.empty()) { aabbMin = aabbMax = glm::vec3(0.0f); }
+
+    // Flat axes would divide by zero, any non zero extent decodes them back to aabbMin
+    glm::vec3 extent = aabbMax - aabbMin;
+    glm::vec3 safeExtent = glm::max(extent, glm::vec3(std::numeric_limits<float>::min()));
+    decode.positionScale = glm::vec4(extent, 0.0f);
+    decode.positionOffset = glm::vec4(aabbMin, 1.0f);
+
+    std::vector<PackedVertex> packed(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const MeshVertex &vertex = vertices[i];
+        PackedVertex &out = packed[i];
+
+        glm::vec3 normalized = glm::clamp((vertex.position - aabbMin) / safeExtent, 0.0f, 1.0f);
+        out.position[0] = glm::packUnorm1x16(normalized.x);
+        out.position[1] = glm::packUnorm1x16(normalized.y);
+        out.position[2] = glm::packUnorm1x16(normalized.z);
+        out.position[3] = 0;
+
+        glm::vec2 octahedral = octahedralEncode(vertex.normal);
+        out.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(octahedral.x));
+        out.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(octahedral.y));
+
+        out.uv[0] = glm::packHalf1x16(vertex.uv.x);
+        out.uv[1] = glm::packHalf1x16(vertex.uv.y);
+
+        out.color = glm::packUnorm4x8(glm::clamp(vertex.color, 0.0f, 1.0f));
+    }
+
+    return packed;
+}
+
+float MeshOptimizer::computeACMR(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize) {
+    if (indices.empty()) { return 0.0f; }
+
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    size_t misses = 0;
+
+    for (uint32_t index: indices) {
+        if (time - timestamps[index] > cacheSize) {
+            timestamps[index] = time++;
+            misses++;
+        }
+    }
+
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+glm::vec2 MeshOptimizer::octahedralEncode(glm::vec3 normal) {
+    float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (length == 0.0f) { return glm::vec2(0.0f); }
+    normal /= length;
+
+    glm::vec2 encoded(normal.x, normal.y);
+    if (normal.z < 0.0f) {
+        // Fold the lower hemisphere over the diagonals
+        glm::vec2 signs(normal.x >= 0.0f ? 1.0f : -1.0f, normal.y >= 0.0f ? 1.0f : -1.0f);
+        encoded = (glm::vec2(1.0f) - glm::abs(glm::vec2(normal.y, normal.x))) * signs;
+    }
+    return encoded;
+}
@@ -0,0 +1,449 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include "headers/memory.h"
+#include "headers/multiview.h"
+
+// Public
+void MultiviewRenderer::create(VkPhysicalDevice physicalDevice, VkDevice device, VkFormat colorFormat,
+                               VkExtent2D extent, uint32_t viewCount) {
+    if (viewCount == 0) { throw std::runtime_error("Multiview rendering needs at least one view!"); }
+
+    this->physicalDevice = physicalDevice;
+    this->device = device;
+    this->colorFormat = colorFormat;
+    this->extent = extent;
+    this->viewCount = viewCount;
+
+    // View masks are 32 bits wide regardless of what the device reports
+    const uint32_t maxViews = std::min(queryMaxViewCount(physicalDevice), 32u);
+
+    // Equal batches waste at most batchCount - 1 padding layers, instead of a nearly empty last batch
+    batchCount = (viewCount + maxViews - 1) / maxViews;
+    batchSize = (viewCount + batchCount - 1) / batchCount;
+
+    createImages();
+    createRenderPass();
+    createFramebuffers();
+    createViewBuffer();
+    createDescriptors();
+}
+
+void MultiviewRenderer::destroy() {
+    if (VK_NULL_HANDLE == device) { return; }
+
+    vkDestroyPipeline(device, pipeline, VK_NULL_HANDLE);
+    vkDestroyPipelineLayout(device, pipelineLayout, VK_NULL_HANDLE);
+    vkDestroyDescriptorPool(device, descriptorPool, VK_NULL_HANDLE);
+    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, VK_NULL_HANDLE);
+
+    vkUnmapMemory(device, viewMemory);
+    vkDestroyBuffer(device, viewBuffer, VK_NULL_HANDLE);
+    vkFreeMemory(device, viewMemory, VK_NULL_HANDLE);
+
+    for (auto framebuffer: framebuffers) { vkDestroyFramebuffer(device, framebuffer, VK_NULL_HANDLE); }
+    for (auto imageView: colorViews) { vkDestroyImageView(device, imageView, VK_NULL_HANDLE); }
+    for (auto imageView: depthViews) { vkDestroyImageView(device, imageView, VK_NULL_HANDLE); }
+    vkDestroyRenderPass(device, renderPass, VK_NULL_HANDLE);
+
+    vkDestroyImage(device, depthImage, VK_NULL_HANDLE);
+    vkFreeMemory(device, depthMemory, VK_NULL_HANDLE);
+    vkDestroyImage(device, colorImage, VK_NULL_HANDLE);
+    vkFreeMemory(device, colorMemory, VK_NULL_HANDLE);
+
+    framebuffers.clear();
+    colorViews.clear();
+    depthViews.clear();
+    device = VK_NULL_HANDLE;
+}
+
+void MultiviewRenderer::createPipeline(VkShaderModule vertShaderModule, VkShaderModule fragShaderModule) {
+    VkPipelineShaderStageCreateInfo shaderStages[] = {
+            {
+                    .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                    .stage = VK_SHADER_STAGE_VERTEX_BIT,
+                    .module = vertShaderModule,
+                    .pName = "main",
+            },
+            {
+                    .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                    .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+                    .module = fragShaderModule,
+                    .pName = "main",
+            },
+    };
+
+    auto bindingDescription = PackedVertex::getBindingDescription();
+    auto attributeDescriptions = PackedVertex::getAttributeDescriptions();
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+            .vertexBindingDescriptionCount = 1,
+            .pVertexBindingDescriptions = &bindingDescription,
+            .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size()),
+            .pVertexAttributeDescriptions = attributeDescriptions.data(),
+    };
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+            .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+            .primitiveRestartEnable = VK_FALSE,
+    };
+
+    // Every view shares the same viewport, the target never changes size
+    VkViewport viewport = {
+            .x = 0.0f,
+            .y = 0.0f,
+            .width = static_cast<float>(extent.width),
+            .height = static_cast<float>(extent.height),
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f,
+    };
+    VkRect2D scissor = {.offset = {0, 0}, .extent = extent};
+    VkPipelineViewportStateCreateInfo viewportState = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+            .viewportCount = 1,
+            .pViewports = &viewport,
+            .scissorCount = 1,
+            .pScissors = &scissor,
+    };
+
+    VkPipelineRasterizationStateCreateInfo rasterizer = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+            .depthClampEnable = VK_FALSE,
+            .rasterizerDiscardEnable = VK_FALSE,
+            .polygonMode = VK_POLYGON_MODE_FILL,
+            .cullMode = VK_CULL_MODE_BACK_BIT,
+            // Same winding as the scene pipelines, the flipped projection Y keeps world space front faces clockwise
+            .frontFace = VK_FRONT_FACE_CLOCKWISE,
+            .depthBiasEnable = VK_FALSE,
+            .lineWidth = 1.0f,
+    };
+
+    VkPipelineMultisampleStateCreateInfo multisampling = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+            .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+            .sampleShadingEnable = VK_FALSE,
+    };
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+            .depthTestEnable = VK_TRUE,
+            .depthWriteEnable = VK_TRUE,
+            .depthCompareOp = VK_COMPARE_OP_LESS,
+            .depthBoundsTestEnable = VK_FALSE,
+            .stencilTestEnable = VK_FALSE,
+    };
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {
+            .blendEnable = VK_FALSE,
+            .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
+                              VK_COLOR_COMPONENT_A_BIT,
+    };
+    VkPipelineColorBlendStateCreateInfo colorBlending = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+            .logicOpEnable = VK_FALSE,
+            .attachmentCount = 1,
+            .pAttachments = &colorBlendAttachment,
+    };
+
+    VkGraphicsPipelineCreateInfo pipelineInfo = {
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            .stageCount = 2,
+            .pStages = shaderStages,
+            .pVertexInputState = &vertexInputInfo,
+            .pInputAssemblyState = &inputAssembly,
+            .pViewportState = &viewportState,
+            .pRasterizationState = &rasterizer,
+            .pMultisampleState = &multisampling,
+            .pDepthStencilState = &depthStencil,
+            .pColorBlendState = &colorBlending,
+            .layout = pipelineLayout,
+            .renderPass = renderPass,
+            .subpass = 0,
+    };
+
+    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, VK_NULL_HANDLE, &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create multiview graphics pipeline!");
+    }
+}
+
+void MultiviewRenderer::setViewMatrices(const std::vector<glm::mat4> &viewProjections) {
+    if (viewProjections.size() != viewCount) { throw std::runtime_error("Expected one matrix per view!"); }
+
+    memcpy(mappedViews, viewProjections.data(), viewProjections.size() * sizeof(glm::mat4));
+    for (uint32_t layer = viewCount; layer < getLayerCount(); layer++) { mappedViews[layer] = viewProjections.back(); }
+}
+
+void MultiviewRenderer::record(VkCommandBuffer commandBuffer, const DrawCallback &drawScene) {
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    for (uint32_t batch = 0; batch < batchCount; batch++) {
+        VkRenderPassBeginInfo renderPassInfo = {
+                .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+                .renderPass = renderPass,
+                .framebuffer = framebuffers[batch],
+                .renderArea = {.offset = {0, 0}, .extent = extent},
+                .clearValueCount = static_cast<uint32_t>(clearValues.size()),
+                .pClearValues = clearValues.data(),
+        };
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        if (VK_NULL_HANDLE != pipeline) {
+            const uint32_t firstView = batch * batchSize;
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1,
+                                    &descriptorSet, 0, VK_NULL_HANDLE);
+            vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
+                               offsetof(PushConstants, firstView), sizeof(uint32_t), &firstView);
+            drawScene(commandBuffer, pipelineLayout);
+        }
+
+        vkCmdEndRenderPass(commandBuffer);
+    }
+}
+
+uint32_t MultiviewRenderer::queryMaxViewCount(VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceMultiviewProperties multiviewProperties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_PROPERTIES,
+    };
+    VkPhysicalDeviceProperties2 properties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &multiviewProperties,
+    };
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+    return std::max(multiviewProperties.maxMultiviewViewCount, 1u);
+}
+
+
+// Private
+void MultiviewRenderer::createImages() {
+    colorImage = createLayeredImage(colorFormat,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                            VK_IMAGE_USAGE_SAMPLED_BIT,
+                                    colorMemory);
+    depthImage = createLayeredImage(depthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, depthMemory);
+
+    for (uint32_t batch = 0; batch < batchCount; batch++) {
+        colorViews.push_back(createLayerView(colorImage, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, batch * batchSize));
+        depthViews.push_back(createLayerView(depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, batch * batchSize));
+    }
+}
+
+void MultiviewRenderer::createRenderPass() {
+    std::array<VkAttachmentDescription, 2> attachments = {{
+            {
+                    .format = colorFormat,
+                    .samples = VK_SAMPLE_COUNT_1_BIT,
+                    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                    .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+                    .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                    .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                    .finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,  // Offline results are read back
+            },
+            {
+                    .format = depthFormat,
+                    .samples = VK_SAMPLE_COUNT_1_BIT,
+                    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                    .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                    .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                    .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                    .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            },
+    }};
+
+    VkAttachmentReference colorAttachmentRef = {.attachment = 0, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference depthAttachmentRef = {
+            .attachment = 1,
+            .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+    };
+
+    VkSubpassDescription subpass = {
+            .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .colorAttachmentCount = 1,
+            .pColorAttachments = &colorAttachmentRef,
+            .pDepthStencilAttachment = &depthAttachmentRef,
+    };
+
+    // Each batch renders up to 32 views, so the mask of its first batchSize bits covers every view
+    const uint32_t viewMask = batchSize >= 32 ? ~0u : (1u << batchSize) - 1;
+    VkRenderPassMultiviewCreateInfo multiviewInfo = {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO,
+            .subpassCount = 1,
+            .pViewMasks = &viewMask,
+    };
+
+    VkRenderPassCreateInfo renderPassInfo = {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+            .pNext = &multiviewInfo,
+            .attachmentCount = static_cast<uint32_t>(attachments.size()),
+            .pAttachments = attachments.data(),
+            .subpassCount = 1,
+            .pSubpasses = &subpass,
+    };
+
+    if (vkCreateRenderPass(device, &renderPassInfo, VK_NULL_HANDLE, &renderPass) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create multiview render pass!");
+    }
+}
+
+void MultiviewRenderer::createFramebuffers() {
+    framebuffers.resize(batchCount);
+    for (uint32_t batch = 0; batch < batchCount; batch++) {
+        std::array<VkImageView, 2> attachments = {colorViews[batch], depthViews[batch]};
+
+        // With multiview the layer count must be 1, the view mask selects the layers
+        VkFramebufferCreateInfo framebufferInfo = {
+                .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+                .renderPass = renderPass,
+                .attachmentCount = static_cast<uint32_t>(attachments.size()),
+                .pAttachments = attachments.data(),
+                .width = extent.width,
+                .height = extent.height,
+                .layers = 1,
+        };
+
+        if (vkCreateFramebuffer(device, &framebufferInfo, VK_NULL_HANDLE, &framebuffers[batch]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create multiview framebuffer!");
+        }
+    }
+}
+
+void MultiviewRenderer::createViewBuffer() {
+    VkBufferCreateInfo bufferInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = sizeof(glm::mat4) * getLayerCount(),
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+    if (vkCreateBuffer(device, &bufferInfo, VK_NULL_HANDLE, &viewBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create multiview matrix buffer!");
+    }
+
+    viewMemory = allocateBufferMemory(physicalDevice, device, viewBuffer,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    void *mapped;
+    vkMapMemory(device, viewMemory, 0, bufferInfo.size, 0, &mapped);
+    mappedViews = static_cast<glm::mat4 *>(mapped);
+    std::fill(mappedViews, mappedViews + getLayerCount(), glm::mat4(1.0f));
+}
+
+void MultiviewRenderer::createDescriptors() {
+    VkDescriptorSetLayoutBinding binding = {
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+    };
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindings = &binding,
+    };
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, VK_NULL_HANDLE, &descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create multiview descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize = {.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1};
+    VkDescriptorPoolCreateInfo poolInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .maxSets = 1,
+            .poolSizeCount = 1,
+            .pPoolSizes = &poolSize,
+    };
+    if (vkCreateDescriptorPool(device, &poolInfo, VK_NULL_HANDLE, &descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create multiview descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = descriptorPool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &descriptorSetLayout,
+    };
+    if (vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate multiview descriptor set!");
+    }
+
+    VkDescriptorBufferInfo bufferInfo = {.buffer = viewBuffer, .offset = 0, .range = VK_WHOLE_SIZE};
+    VkWriteDescriptorSet write = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = descriptorSet,
+            .dstBinding = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &bufferInfo,
+    };
+    vkUpdateDescriptorSets(device, 1, &write, 0, VK_NULL_HANDLE);
+
+    VkPushConstantRange pushConstantRange = {
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+            .offset = 0,
+            .size = sizeof(PushConstants),
+    };
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 1,
+            .pSetLayouts = &descriptorSetLayout,
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pushConstantRange,
+    };
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, VK_NULL_HANDLE, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create multiview pipeline layout!");
+    }
+}
+
+VkImage MultiviewRenderer::createLayeredImage(VkFormat format, VkImageUsageFlags usage, VkDeviceMemory &memory) {
+    VkImageCreateInfo imageInfo = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = format,
+            .extent = {extent.width, extent.height, 1},
+            .mipLevels = 1,
+            .arrayLayers = getLayerCount(),
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+
+    VkImage image;
+    if (vkCreateImage(device, &imageInfo, VK_NULL_HANDLE, &image) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create layered image!");
+    }
+    memory = allocateImageMemory(physicalDevice, device, image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    return image;
+}
+
+VkImageView MultiviewRenderer::createLayerView(VkImage image, VkFormat format, VkImageAspectFlags aspect,
+                                               uint32_t baseLayer) {
+    VkImageViewCreateInfo createInfo = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = image,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+            .format = format,
+            .subresourceRange =
+                    {
+                            .aspectMask = aspect,
+                            .baseMipLevel = 0,
+                            .levelCount = 1,
+                            .baseArrayLayer = baseLayer,
+                            .layerCount = batchSize,
+                    },
+    };
+
+    VkImageView imageView;
+    if (vkCreateImageView(device, &createInfo, VK_NULL_HANDLE, &imageView) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create layered image view!");
+    }
+    return imageView;
+}
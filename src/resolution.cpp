@@ -0,0 +1,455 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+#include "headers/memory.h"
+#include "headers/resolution.h"
+
+// ResolutionController
+void ResolutionController::configure(const Settings &settings) {
+    if (settings.gpuBudgetMs <= 0.0f || settings.minScale <= 0.0f || settings.minScale > settings.maxScale) {
+        throw std::runtime_error("Invalid dynamic resolution settings!");
+    }
+
+    this->settings = settings;
+    scale = settings.maxScale;
+    smoothedGpuTimeMs = 0.0f;
+}
+
+float ResolutionController::update(float gpuTimeMs) {
+    if (gpuTimeMs <= 0.0f) { return scale; }
+
+    smoothedGpuTimeMs =
+            smoothedGpuTimeMs == 0.0f ? gpuTimeMs : smoothedGpuTimeMs + (gpuTimeMs - smoothedGpuTimeMs) * smoothing;
+
+    // A spike means frames are already being dropped, so correct in full right away instead of easing in
+    const bool spike = gpuTimeMs > settings.gpuBudgetMs * spikeFactor;
+    const float measured = spike ? gpuTimeMs : smoothedGpuTimeMs;
+    const float ratio = settings.gpuBudgetMs / measured;
+    if (std::abs(ratio - 1.0f) < deadBand) { return scale; }
+
+    const float target = scale * std::sqrt(ratio);
+    scale += (target - scale) * (spike ? 1.0f : gain);
+    scale = std::clamp(scale, settings.minScale, settings.maxScale);
+    return scale;
+}
+
+VkExtent2D ResolutionController::scaleExtent(VkExtent2D extent, float scale) {
+    auto scaleDimension = [scale](uint32_t dimension) {
+        auto scaled = static_cast<uint32_t>(std::lround(static_cast<float>(dimension) * scale));
+        return std::clamp(scaled, 1u, std::max(dimension, 1u));
+    };
+    return {scaleDimension(extent.width), scaleDimension(extent.height)};
+}
+
+
+// ScaledRenderTarget
+void ScaledRenderTarget::create(VkPhysicalDevice physicalDevice, VkDevice device, VkFormat format,
+                                VkExtent2D maxExtent, VkFormat swapChainFormat, uint32_t framesInFlight) {
+    this->physicalDevice = physicalDevice;
+    this->device = device;
+    this->format = format;
+    this->swapChainFormat = swapChainFormat;
+    this->maxExtent = maxExtent;
+    this->renderExtent = maxExtent;
+
+    VkFormatProperties sourceProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &sourceProperties);
+    VkFormatProperties destinationProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, swapChainFormat, &destinationProperties);
+
+    // Without blits the caller renders directly into the swapchain, the offscreen target is still usable on its own
+    upscaleSupported = (sourceProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT) &&
+                       (destinationProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
+
+    // Fall back to point sampling rather than failing when the format cannot be filtered
+    blitFilter = (sourceProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+                         ? VK_FILTER_LINEAR
+                         : VK_FILTER_NEAREST;
+
+    // The offscreen pass is always created, pipelines are built against it whichever path renders the frames
+    createDepthImage();
+    renderPass = createRenderPass(false);
+    createQueryPool(framesInFlight);
+}
+
+void ScaledRenderTarget::createOffscreenFramebuffer() {
+    createImage();
+
+    std::array<VkImageView, 2> attachments = {imageView, depthImageView};
+    VkFramebufferCreateInfo framebufferInfo = {
+            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+            .renderPass = renderPass,
+            .attachmentCount = static_cast<uint32_t>(attachments.size()),
+            .pAttachments = attachments.data(),
+            .width = maxExtent.width,
+            .height = maxExtent.height,
+            .layers = 1,
+    };
+    if (vkCreateFramebuffer(device, &framebufferInfo, VK_NULL_HANDLE, &framebuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scaled render target framebuffer!");
+    }
+}
+
+void ScaledRenderTarget::destroy() {
+    if (VK_NULL_HANDLE == device) { return; }
+
+    vkDestroyQueryPool(device, queryPool, VK_NULL_HANDLE);
+    for (auto swapChainFramebuffer: swapChainFramebuffers) {
+        vkDestroyFramebuffer(device, swapChainFramebuffer, VK_NULL_HANDLE);
+    }
+    swapChainFramebuffers.clear();
+    vkDestroyRenderPass(device, swapChainRenderPass, VK_NULL_HANDLE);
+    vkDestroyFramebuffer(device, framebuffer, VK_NULL_HANDLE);
+    vkDestroyRenderPass(device, renderPass, VK_NULL_HANDLE);
+    vkDestroyImageView(device, depthImageView, VK_NULL_HANDLE);
+    vkDestroyImage(device, depthImage, VK_NULL_HANDLE);
+    vkFreeMemory(device, depthMemory, VK_NULL_HANDLE);
+    vkDestroyImageView(device, imageView, VK_NULL_HANDLE);
+    vkDestroyImage(device, image, VK_NULL_HANDLE);
+    vkFreeMemory(device, memory, VK_NULL_HANDLE);
+    device = VK_NULL_HANDLE;
+}
+
+void ScaledRenderTarget::createSwapChainFramebuffers(const std::vector<VkImageView> &swapChainImageViews,
+                                                     VkExtent2D swapChainExtent) {
+    // Pipelines are built against the offscreen render pass, they only stay compatible if the formats match
+    if (format != swapChainFormat) {
+        throw std::runtime_error("Rendering directly to the swapchain needs the target to use the swapchain format!");
+    }
+    // The depth image is shared with the offscreen pass and only covers the maximum extent
+    if (swapChainExtent.width > maxExtent.width || swapChainExtent.height > maxExtent.height) {
+        throw std::runtime_error("Swapchain is larger than the scaled render target!");
+    }
+
+    this->swapChainExtent = swapChainExtent;
+    swapChainRenderPass = createRenderPass(true);
+
+    swapChainFramebuffers.resize(swapChainImageViews.size());
+    for (size_t i = 0; i < swapChainImageViews.size(); i++) {
+        std::array<VkImageView, 2> attachments = {swapChainImageViews[i], depthImageView};
+        VkFramebufferCreateInfo framebufferInfo = {
+                .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+                .renderPass = swapChainRenderPass,
+                .attachmentCount = static_cast<uint32_t>(attachments.size()),
+                .pAttachments = attachments.data(),
+                .width = swapChainExtent.width,
+                .height = swapChainExtent.height,
+                .layers = 1,
+        };
+        if (vkCreateFramebuffer(device, &framebufferInfo, VK_NULL_HANDLE, &swapChainFramebuffers[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create swapchain framebuffer!");
+        }
+    }
+}
+
+void ScaledRenderTarget::beginScene(VkCommandBuffer commandBuffer, uint32_t frame, VkExtent2D renderExtent) {
+    this->renderExtent = {std::min(renderExtent.width, maxExtent.width),
+                          std::min(renderExtent.height, maxExtent.height)};
+    begin(commandBuffer, frame, renderPass, framebuffer, this->renderExtent);
+}
+
+void ScaledRenderTarget::beginDirectScene(VkCommandBuffer commandBuffer, uint32_t frame, uint32_t imageIndex) {
+    renderExtent = swapChainExtent;
+    begin(commandBuffer, frame, swapChainRenderPass, swapChainFramebuffers[imageIndex], swapChainExtent);
+}
+
+void ScaledRenderTarget::endSceneAndUpscale(VkCommandBuffer commandBuffer, uint32_t frame, VkImage swapChainImage,
+                                            VkExtent2D swapChainExtent) {
+    // Timed before the blit: it waits on the acquire semaphore, which would add vsync to the measured scene time.
+    // The render pass leaves the target in TRANSFER_SRC_OPTIMAL.
+    endScene(commandBuffer, frame);
+
+    VkImageMemoryBarrier toTransfer = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = 0,
+            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = swapChainImage,
+            .subresourceRange =
+                    {
+                            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                            .baseMipLevel = 0,
+                            .levelCount = 1,
+                            .baseArrayLayer = 0,
+                            .layerCount = 1,
+                    },
+    };
+    // Chains with the image available semaphore, which is waited on at the transfer stage
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                         VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &toTransfer);
+
+    VkImageBlit blit = {
+            .srcSubresource = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = 0, .baseArrayLayer = 0,
+                               .layerCount = 1},
+            .srcOffsets = {{0, 0, 0},
+                           {static_cast<int32_t>(renderExtent.width), static_cast<int32_t>(renderExtent.height), 1}},
+            .dstSubresource = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = 0, .baseArrayLayer = 0,
+                               .layerCount = 1},
+            .dstOffsets = {{0, 0, 0},
+                           {static_cast<int32_t>(swapChainExtent.width), static_cast<int32_t>(swapChainExtent.height),
+                            1}},
+    };
+    vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swapChainImage,
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, blitFilter);
+
+    VkImageMemoryBarrier toPresent = toTransfer;
+    toPresent.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toPresent.dstAccessMask = 0;
+    toPresent.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toPresent.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                         VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &toPresent);
+}
+
+void ScaledRenderTarget::endScene(VkCommandBuffer commandBuffer, uint32_t frame) {
+    vkCmdEndRenderPass(commandBuffer);
+
+    if (VK_NULL_HANDLE != queryPool) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, frame * 2 + 1);
+        queriesWritten[frame] = true;
+    }
+}
+
+std::optional<float> ScaledRenderTarget::readGpuTimeMs(uint32_t frame) {
+    if (VK_NULL_HANDLE == queryPool || !queriesWritten[frame]) { return std::nullopt; }
+
+    std::array<uint64_t, 2> timestamps{};
+    VkResult result = vkGetQueryPoolResults(device, queryPool, frame * 2, 2, sizeof(timestamps), timestamps.data(),
+                                            sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS || timestamps[1] < timestamps[0]) { return std::nullopt; }
+
+    return static_cast<float>(static_cast<double>(timestamps[1] - timestamps[0]) * timestampPeriodNs / 1e6);
+}
+
+
+// Private
+void ScaledRenderTarget::begin(VkCommandBuffer commandBuffer, uint32_t frame, VkRenderPass pass, VkFramebuffer target,
+                               VkExtent2D extent) {
+    if (VK_NULL_HANDLE != queryPool) {
+        vkCmdResetQueryPool(commandBuffer, queryPool, frame * 2, 2);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, frame * 2);
+    }
+
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    clearValues[1].depthStencil = {1.0f, 0};
+    VkRenderPassBeginInfo renderPassInfo = {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass = pass,
+            .framebuffer = target,
+            .renderArea = {.offset = {0, 0}, .extent = extent},
+            .clearValueCount = static_cast<uint32_t>(clearValues.size()),
+            .pClearValues = clearValues.data(),
+    };
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+    VkViewport viewport = {
+            .x = 0.0f,
+            .y = 0.0f,
+            .width = static_cast<float>(extent.width),
+            .height = static_cast<float>(extent.height),
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f,
+    };
+    VkRect2D scissor = {.offset = {0, 0}, .extent = extent};
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+void ScaledRenderTarget::createImage() {
+    VkImageCreateInfo imageInfo = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = format,
+            .extent = {maxExtent.width, maxExtent.height, 1},
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+    if (vkCreateImage(device, &imageInfo, VK_NULL_HANDLE, &image) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scaled render target image!");
+    }
+    memory = allocateImageMemory(physicalDevice, device, image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    VkImageViewCreateInfo viewInfo = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = image,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = format,
+            .subresourceRange =
+                    {
+                            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                            .baseMipLevel = 0,
+                            .levelCount = 1,
+                            .baseArrayLayer = 0,
+                            .layerCount = 1,
+                    },
+    };
+    if (vkCreateImageView(device, &viewInfo, VK_NULL_HANDLE, &imageView) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scaled render target image view!");
+    }
+}
+
+void ScaledRenderTarget::createDepthImage() {
+    VkImageCreateInfo imageInfo = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = depthFormat,
+            .extent = {maxExtent.width, maxExtent.height, 1},
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+    if (vkCreateImage(device, &imageInfo, VK_NULL_HANDLE, &depthImage) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scaled render target depth image!");
+    }
+    depthMemory = allocateImageMemory(physicalDevice, device, depthImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    VkImageViewCreateInfo viewInfo = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = depthImage,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = depthFormat,
+            .subresourceRange =
+                    {
+                            .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
+                            .baseMipLevel = 0,
+                            .levelCount = 1,
+                            .baseArrayLayer = 0,
+                            .layerCount = 1,
+                    },
+    };
+    if (vkCreateImageView(device, &viewInfo, VK_NULL_HANDLE, &depthImageView) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scaled render target depth image view!");
+    }
+}
+
+VkRenderPass ScaledRenderTarget::createRenderPass(bool toSwapChain) {
+    // Only the final layout and the dependencies differ, which keeps both passes compatible
+    std::array<VkAttachmentDescription, 2> attachments = {{
+            {
+                    .format = format,
+                    .samples = VK_SAMPLE_COUNT_1_BIT,
+                    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                    .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+                    .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                    .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                    .finalLayout =
+                            toSwapChain ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            },
+            {
+                    .format = depthFormat,
+                    .samples = VK_SAMPLE_COUNT_1_BIT,
+                    .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                    .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                    .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                    .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                    .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                    .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            },
+    }};
+
+    VkAttachmentReference colorAttachmentRef = {.attachment = 0, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference depthAttachmentRef = {
+            .attachment = 1,
+            .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+    };
+
+    VkSubpassDescription subpass = {
+            .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .colorAttachmentCount = 1,
+            .pColorAttachments = &colorAttachmentRef,
+            .pDepthStencilAttachment = &depthAttachmentRef,
+    };
+
+    // Every frame in flight clears the same depth image, which must wait for the previous frame's depth tests
+    std::vector<VkSubpassDependency> dependencies;
+    dependencies.push_back({
+            .srcSubpass = VK_SUBPASS_EXTERNAL,
+            .dstSubpass = 0,
+            .srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+            .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask =
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+    });
+    if (toSwapChain) {
+        // The swapchain image is only written once the acquire semaphore, waited on at this stage, has signaled
+        dependencies.push_back({
+                .srcSubpass = VK_SUBPASS_EXTERNAL,
+                .dstSubpass = 0,
+                .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                .srcAccessMask = 0,
+                .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        });
+    } else {
+        // One target is shared by every frame in flight: the next frame may only draw once the previous blit read
+        // it, and the blit may only read once drawing finished
+        dependencies.push_back({
+                .srcSubpass = VK_SUBPASS_EXTERNAL,
+                .dstSubpass = 0,
+                .srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                .srcAccessMask = 0,
+                .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        });
+        dependencies.push_back({
+                .srcSubpass = 0,
+                .dstSubpass = VK_SUBPASS_EXTERNAL,
+                .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+        });
+    }
+
+    VkRenderPassCreateInfo renderPassInfo = {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+            .attachmentCount = static_cast<uint32_t>(attachments.size()),
+            .pAttachments = attachments.data(),
+            .subpassCount = 1,
+            .pSubpasses = &subpass,
+            .dependencyCount = static_cast<uint32_t>(dependencies.size()),
+            .pDependencies = dependencies.data(),
+    };
+
+    VkRenderPass pass;
+    if (vkCreateRenderPass(device, &renderPassInfo, VK_NULL_HANDLE, &pass) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create scaled render pass!");
+    }
+    return pass;
+}
+
+void ScaledRenderTarget::createQueryPool(uint32_t framesInFlight) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    // Without timestamps the controller never gets a sample and the scale stays at its maximum
+    if (!properties.limits.timestampComputeAndGraphics) { return; }
+    timestampPeriodNs = properties.limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo queryPoolInfo = {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = framesInFlight * 2,
+    };
+    if (vkCreateQueryPool(device, &queryPoolInfo, VK_NULL_HANDLE, &queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool!");
+    }
+    queriesWritten.assign(framesInFlight, false);
+}
@@ -0,0 +1,14 @@
+#version 450
+
+// Streamed texture, only its resident mips are in the image view
+layout(set = 0, binding = 0) uniform sampler2D albedo;
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragNormal;
+layout(location = 2) in vec2 fragUV;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = vec4(fragColor * texture(albedo, fragUV).rgb, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#version 450
+
+// Must match MeshDecodeConstants in mesh.h
+layout(push_constant) uniform MeshDecode {
+    vec4 positionScale;
+    vec4 positionOffset;
+} meshDecode;
+
+layout(location = 0) in vec4 inPosition;  // R16G16B16A16_UNORM, relative to the mesh AABB
+layout(location = 1) in vec2 inNormal;    // R16G16_SNORM, octahedral encoded
+layout(location = 2) in vec2 inUV;        // R16G16_SFLOAT
+layout(location = 3) in vec4 inColor;     // R8G8B8A8_UNORM
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragUV;
+
+vec3 octahedralDecode(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = clamp(-normal.z, 0.0, 1.0);
+    normal.xy += vec2(normal.x >= 0.0 ? -fold : fold, normal.y >= 0.0 ? -fold : fold);
+    return normalize(normal);
+}
+
+void main() {
+    vec3 position = inPosition.xyz * meshDecode.positionScale.xyz + meshDecode.positionOffset.xyz;
+
+    gl_Position = vec4(position, 1.0);
+    fragColor = inColor.rgb;
+    fragNormal = octahedralDecode(inNormal);
+    fragUV = inUV;
+}
@@ -0,0 +1,28 @@
+#version 450
+#extension GL_EXT_multiview : enable
+
+// Must match MultiviewRenderer::PushConstants in multiview.h
+layout(push_constant) uniform Constants {
+    vec4 positionScale;
+    vec4 positionOffset;
+    uint firstView;
+} constants;
+
+// One view-projection matrix per array layer
+layout(std430, set = 0, binding = 0) readonly buffer ViewMatrices {
+    mat4 viewProjection[];
+} views;
+
+layout(location = 0) in vec4 inPosition;  // R16G16B16A16_UNORM, relative to the mesh AABB
+layout(location = 1) in vec2 inNormal;    // R16G16_SNORM, octahedral encoded
+layout(location = 2) in vec2 inUV;        // R16G16_SFLOAT
+layout(location = 3) in vec4 inColor;     // R8G8B8A8_UNORM
+
+layout(location = 0) out vec3 fragColor;
+
+void main() {
+    vec3 position = inPosition.xyz * constants.positionScale.xyz + constants.positionOffset.xyz;
+
+    gl_Position = views.viewProjection[constants.firstView + gl_ViewIndex] * vec4(position, 1.0);
+    fragColor = inColor.rgb;
+}
@@ -1,5 +1,15 @@
 #version 450
 
+// Set indices must match DrawList::materialSetIndex and DrawList::objectSetIndex
+layout(set = 0, binding = 0) uniform MaterialUniforms {
+    vec4 tint;
+} material;
+
+// One block per frame, every draw picks its transform with firstInstance
+layout(std430, set = 1, binding = 0) readonly buffer ObjectData {
+    mat4 transforms[];
+} objects;
+
 layout(location = 0) out vec3 fragColor;
 
 vec2 positions[3] = vec2[](vec2(0.0, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
@@ -7,6 +17,6 @@ vec2 positions[3] = vec2[](vec2(0.0, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
 vec3 colors[3] = vec3[](vec3(1.0, 0.0, 0.0), vec3(0.0, 1.1, 0.0), vec3(0.0, 0.0, 1.0));
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
+    gl_Position = objects.transforms[gl_InstanceIndex] * vec4(positions[gl_VertexIndex], 0.0, 1.0);
+    fragColor = colors[gl_VertexIndex] * material.tint.rgb;
 }
@@ -0,0 +1,616 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "headers/memory.h"
+#include "headers/texture.h"
+
+// Public
+void TextureStreamer::create(VkPhysicalDevice physicalDevice, VkDevice device, VkQueue queue,
+                             uint32_t queueFamilyIndex, bool memoryBudgetSupported, VkDeviceSize budgetCapBytes,
+                             uint32_t framesInFlight) {
+    this->physicalDevice = physicalDevice;
+    this->device = device;
+    this->queue = queue;
+    this->budgetCapBytes = budgetCapBytes;
+
+    // vkGetPhysicalDeviceMemoryProperties2, and with it the budget extension, needs a 1.1 device
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    memoryProperties2Supported = properties.apiVersion >= VK_API_VERSION_1_1;
+    this->memoryBudgetSupported = memoryBudgetSupported && memoryProperties2Supported;
+
+    VkCommandPoolCreateInfo poolInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            .queueFamilyIndex = queueFamilyIndex,
+    };
+    if (vkCreateCommandPool(device, &poolInfo, VK_NULL_HANDLE, &commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create texture upload command pool!");
+    }
+
+    uploadSlots.resize(framesInFlight);
+    for (auto &slot: uploadSlots) {
+        VkCommandBufferAllocateInfo allocInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = commandPool,
+                .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                .commandBufferCount = 1,
+        };
+        if (vkAllocateCommandBuffers(device, &allocInfo, &slot.commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate texture upload command buffer!");
+        }
+
+        // Signaled so the first update of each slot does not wait
+        VkFenceCreateInfo fenceInfo = {
+                .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+                .flags = VK_FENCE_CREATE_SIGNALED_BIT,
+        };
+        if (vkCreateFence(device, &fenceInfo, VK_NULL_HANDLE, &slot.fence) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create texture upload fence!");
+        }
+
+        reserveStaging(slot, maxUploadBytesPerUpdate);
+    }
+    currentSlot = 0;
+
+    budgetBytes = queryBudget();
+}
+
+void TextureStreamer::destroy() {
+    if (VK_NULL_HANDLE == device) { return; }
+
+    for (const auto &slot: uploadSlots) { vkWaitForFences(device, 1, &slot.fence, VK_TRUE, UINT64_MAX); }
+
+    for (auto &texture: textures) { retire(texture); }
+    for (auto &slot: uploadSlots) {
+        destroyRetired(slot);
+        vkDestroyFence(device, slot.fence, VK_NULL_HANDLE);
+        vkUnmapMemory(device, slot.stagingMemory);
+        vkDestroyBuffer(device, slot.stagingBuffer, VK_NULL_HANDLE);
+        vkFreeMemory(device, slot.stagingMemory, VK_NULL_HANDLE);
+    }
+    uploadSlots.clear();
+    textures.clear();
+
+    vkDestroyCommandPool(device, commandPool, VK_NULL_HANDLE);
+    device = VK_NULL_HANDLE;
+}
+
+uint32_t TextureStreamer::addTexture(uint32_t width, uint32_t height, std::vector<uint8_t> pixels,
+                                     ColorSpace colorSpace) {
+    if (pixels.size() != static_cast<size_t>(width) * height * 4) {
+        throw std::runtime_error("Texture pixel data does not match its dimensions!");
+    }
+
+    return registerTexture(width, height, generateMips(width, height, std::move(pixels), colorSpace), colorSpace);
+}
+
+JobSystem::JobHandle TextureStreamer::addTextureAsync(JobSystem &jobSystem, uint32_t width, uint32_t height,
+                                                      std::vector<uint8_t> pixels, ColorSpace colorSpace,
+                                                      std::function<void(uint32_t)> onLoaded) {
+    if (pixels.size() != static_cast<size_t>(width) * height * 4) {
+        throw std::runtime_error("Texture pixel data does not match its dimensions!");
+    }
+
+    auto mips = std::make_shared<std::vector<std::vector<uint8_t>>>();
+    auto source = std::make_shared<std::vector<uint8_t>>(std::move(pixels));
+
+    JobSystem::JobHandle mipsGenerated = jobSystem.schedule(
+            [mips, source, width, height, colorSpace]() {
+                *mips = generateMips(width, height, std::move(*source), colorSpace);
+            });
+
+    return jobSystem.schedule(
+            [this, mips, width, height, colorSpace, onLoaded = std::move(onLoaded)]() {
+                onLoaded(registerTexture(width, height, std::move(*mips), colorSpace));
+            },
+            {mipsGenerated}, JobSystem::Affinity::MainThread);
+}
+
+void TextureStreamer::requestMip(uint32_t texture, uint32_t mip) {
+    StreamedTexture &streamed = textures[texture];
+    mip = std::min(mip, static_cast<uint32_t>(streamed.mips.size()) - 1);
+
+    // Requests are per frame, the finest one wins
+    if (streamed.lastUsedFrame != currentFrame) {
+        streamed.requestedMip = mip;
+    } else {
+        streamed.requestedMip = std::min(streamed.requestedMip, mip);
+    }
+    streamed.lastUsedFrame = currentFrame;
+}
+
+void TextureStreamer::update(uint64_t frameIndex) {
+    currentFrame = frameIndex;
+    currentSlot = static_cast<uint32_t>(frameIndex % uploadSlots.size());
+    UploadSlot &slot = uploadSlots[currentSlot];
+
+    // Submitted framesInFlight updates ago, waiting on the frame fences has normally signaled it already. Every frame
+    // that could still sample the images this slot retired was submitted before it.
+    vkWaitForFences(device, 1, &slot.fence, VK_TRUE, UINT64_MAX);
+    destroyRetired(slot);
+
+    budgetBytes = queryBudget();
+
+    // Planned mip per texture for this update, starts as the current residency
+    std::vector<uint32_t> plannedMip(textures.size());
+    std::vector<bool> promoted(textures.size(), false);
+    VkDeviceSize plannedBytes = residentBytes;
+    for (size_t i = 0; i < textures.size(); i++) { plannedMip[i] = textures[i].residentMip; }
+
+    uint32_t evictedThisUpdate = 0;
+    auto evictOne = [&]() {
+        // Least recently used texture that was not needed last frame and still has something above its coarse mips
+        size_t victim = textures.size();
+        for (size_t i = 0; i < textures.size(); i++) {
+            const StreamedTexture &texture = textures[i];
+            if (promoted[i] || plannedMip[i] >= texture.coarseMip || texture.lastUsedFrame + 1 >= frameIndex) {
+                continue;
+            }
+            if (victim == textures.size() || texture.lastUsedFrame < textures[victim].lastUsedFrame) { victim = i; }
+        }
+        if (victim == textures.size()) { return false; }
+
+        plannedBytes -= textures[victim].mips[plannedMip[victim]].size();
+        plannedMip[victim]++;
+        evictedThisUpdate++;
+        return true;
+    };
+
+    // Coarse mips of textures registered since the last update go first. They can never be evicted, so the room
+    // they need comes out of the fine mips of other textures.
+    VkDeviceSize uploadBytes = 0;
+    for (size_t i = 0; i < textures.size(); i++) {
+        const StreamedTexture &texture = textures[i];
+        const auto mipCount = static_cast<uint32_t>(texture.mips.size());
+        if (texture.residentMip < mipCount) { continue; }
+
+        VkDeviceSize coarseBytes = mipRangeBytes(texture, texture.coarseMip, mipCount);
+        if (uploadBytes > 0 && uploadBytes + coarseBytes > maxUploadBytesPerUpdate) { break; }
+
+        plannedMip[i] = texture.coarseMip;
+        promoted[i] = true;
+        plannedBytes += coarseBytes;
+        uploadBytes += coarseBytes;
+    }
+
+    // The budget can shrink when other applications allocate, give memory back before streaming anything in
+    while (plannedBytes > budgetBytes && evictOne()) {}
+
+    // Recently used textures first, then the ones furthest from what they asked for
+    std::vector<uint32_t> candidates;
+    for (size_t i = 0; i < textures.size(); i++) {
+        const StreamedTexture &texture = textures[i];
+        if (texture.residentMip < texture.mips.size() && texture.requestedMip < texture.residentMip &&
+            texture.lastUsedFrame + recentUseFrames >= frameIndex) {
+            candidates.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) {
+        if (textures[a].lastUsedFrame != textures[b].lastUsedFrame) {
+            return textures[a].lastUsedFrame > textures[b].lastUsedFrame;
+        }
+        return textures[a].residentMip - textures[a].requestedMip > textures[b].residentMip - textures[b].requestedMip;
+    });
+
+    // Promote one mip per texture per update so bandwidth is spread across frames
+    for (uint32_t id: candidates) {
+        const StreamedTexture &texture = textures[id];
+        // Evicted earlier in this update, streaming it back in right away would only thrash
+        if (plannedMip[id] > texture.residentMip) { continue; }
+
+        // Only the new mip is staged, the resident ones are copied from the old image
+        uint32_t target = plannedMip[id] - 1;
+        VkDeviceSize growth = texture.mips[target].size();
+
+        if (uploadBytes > 0 && uploadBytes + growth > maxUploadBytesPerUpdate) { break; }
+
+        while (plannedBytes + growth > budgetBytes && evictOne()) {}
+        if (plannedBytes + growth > budgetBytes) { break; }
+
+        plannedMip[id] = target;
+        promoted[id] = true;
+        plannedBytes += growth;
+        uploadBytes += growth;
+    }
+
+    std::vector<uint32_t> changedIds;
+    std::vector<uint32_t> changedMips;
+    for (size_t i = 0; i < textures.size(); i++) {
+        if (plannedMip[i] != textures[i].residentMip) {
+            changedIds.push_back(static_cast<uint32_t>(i));
+            changedMips.push_back(plannedMip[i]);
+        }
+    }
+
+    evictions += evictedThisUpdate;
+    evictionRate = evictionRate * 0.9f + static_cast<float>(evictedThisUpdate) * 0.1f;
+
+    // Images are only retired when their residency changes, so without changes there is nothing to upload or to
+    // fence and the slot's fence simply stays signaled
+    if (changedIds.empty()) { return; }
+
+    VkCommandBufferBeginInfo beginInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    vkResetFences(device, 1, &slot.fence);
+    vkResetCommandBuffer(slot.commandBuffer, 0);
+    vkBeginCommandBuffer(slot.commandBuffer, &beginInfo);
+    makeResident(changedIds, changedMips);
+    vkEndCommandBuffer(slot.commandBuffer);
+
+    // The fence tells when this update's retired images are no longer sampled. Queue order places the uploads
+    // before the frame that samples them.
+    VkSubmitInfo submitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &slot.commandBuffer,
+    };
+    if (vkQueueSubmit(queue, 1, &submitInfo, slot.fence) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit texture uploads!");
+    }
+}
+
+TextureStreamer::Stats TextureStreamer::getStats() const {
+    uint32_t pending = 0;
+    for (const auto &texture: textures) {
+        if (texture.requestedMip < texture.residentMip && texture.lastUsedFrame + recentUseFrames >= currentFrame) {
+            pending++;
+        }
+    }
+
+    return {
+            .residentBytes = residentBytes,
+            .budgetBytes = budgetBytes,
+            .pendingRequests = pending,
+            .evictions = evictions,
+            .evictionRate = evictionRate,
+    };
+}
+
+uint32_t TextureStreamer::mipForScreenCoverage(uint32_t width, uint32_t height, float screenPixels) {
+    const uint32_t largest = std::max(width, height);
+    const auto lastMip = static_cast<uint32_t>(std::bit_width(largest)) - 1;
+    if (screenPixels <= 1.0f) { return lastMip; }
+
+    float mip = std::floor(std::log2(static_cast<float>(largest) / screenPixels));
+    if (mip <= 0.0f) { return 0; }
+    return std::min(static_cast<uint32_t>(mip), lastMip);
+}
+
+
+// Private
+uint32_t TextureStreamer::registerTexture(uint32_t width, uint32_t height, std::vector<std::vector<uint8_t>> mips,
+                                          ColorSpace colorSpace) {
+    StreamedTexture texture{
+            .width = width,
+            .height = height,
+            .format = colorSpace == ColorSpace::Srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM,
+            .mips = std::move(mips),
+    };
+
+    const auto mipCount = static_cast<uint32_t>(texture.mips.size());
+    const uint32_t largest = std::max(width, height);
+    texture.coarseMip = 0;
+    while (texture.coarseMip + 1 < mipCount && (largest >> texture.coarseMip) > coarseMipSize) { texture.coarseMip++; }
+    texture.residentMip = mipCount;  // Nothing resident yet, the next update() plans the coarse mips
+    texture.requestedMip = texture.coarseMip;
+    texture.lastUsedFrame = currentFrame;
+
+    textures.push_back(std::move(texture));
+    return static_cast<uint32_t>(textures.size() - 1);
+}
+
+VkDeviceSize TextureStreamer::queryBudget() const {
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+    };
+    VkPhysicalDeviceMemoryProperties2 memoryProperties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+            .pNext = memoryBudgetSupported ? &budgetProperties : VK_NULL_HANDLE,
+    };
+    if (memoryProperties2Supported) {
+        vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &memoryProperties);
+    } else {
+        // Vulkan 1.0 device, only the heap sizes are known
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties.memoryProperties);
+    }
+
+    // Textures live in the largest device local heap
+    const VkPhysicalDeviceMemoryProperties &properties = memoryProperties.memoryProperties;
+    uint32_t heapIndex = 0;
+    VkDeviceSize heapSize = 0;
+    for (uint32_t i = 0; i < properties.memoryHeapCount; i++) {
+        if ((properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) &&
+            properties.memoryHeaps[i].size > heapSize) {
+            heapIndex = i;
+            heapSize = properties.memoryHeaps[i].size;
+        }
+    }
+
+    VkDeviceSize budget;
+    if (!memoryBudgetSupported) {
+        // No usage information, assume half of the heap is taken by everything else
+        budget = static_cast<VkDeviceSize>(static_cast<double>(properties.memoryHeaps[heapIndex].size) * 0.5);
+    } else {
+        // heapUsage includes our own textures, only what everything else uses is subtracted
+        auto allowed = static_cast<VkDeviceSize>(static_cast<double>(budgetProperties.heapBudget[heapIndex]) *
+                                                 budgetFraction);
+        VkDeviceSize heapUsage = budgetProperties.heapUsage[heapIndex];
+        VkDeviceSize otherUsage = heapUsage - std::min(residentBytes, heapUsage);
+        budget = allowed > otherUsage ? allowed - otherUsage : 0;
+    }
+    return budgetCapBytes > 0 ? std::min(budget, budgetCapBytes) : budget;
+}
+
+void TextureStreamer::makeResident(std::vector<uint32_t> &textureIds, std::vector<uint32_t> &targetMips) {
+    UploadSlot &slot = uploadSlots[currentSlot];
+    const VkCommandBuffer commandBuffer = slot.commandBuffer;
+
+    // Levels the old image already holds are copied on the GPU, only the rest goes through the slot's staging buffer
+    VkDeviceSize stagingSize = 0;
+    for (size_t i = 0; i < textureIds.size(); i++) {
+        const StreamedTexture &texture = textures[textureIds[i]];
+        stagingSize += mipRangeBytes(texture, targetMips[i], std::max(targetMips[i], texture.residentMip));
+    }
+    reserveStaging(slot, stagingSize);
+
+    VkDeviceSize stagingOffset = 0;
+    for (size_t i = 0; i < textureIds.size(); i++) {
+        StreamedTexture &texture = textures[textureIds[i]];
+        const auto mipCount = static_cast<uint32_t>(texture.mips.size());
+        const uint32_t firstMip = targetMips[i];
+        const uint32_t levelCount = mipCount - firstMip;
+        // Finest mip the old image can provide, mipCount when there is no old image
+        const uint32_t firstCopiedMip = std::max(firstMip, texture.residentMip);
+
+        VkImageCreateInfo imageInfo = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                .imageType = VK_IMAGE_TYPE_2D,
+                .format = texture.format,
+                .extent = {std::max(texture.width >> firstMip, 1u), std::max(texture.height >> firstMip, 1u), 1},
+                .mipLevels = levelCount,
+                .arrayLayers = 1,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .tiling = VK_IMAGE_TILING_OPTIMAL,
+                .usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                         VK_IMAGE_USAGE_SAMPLED_BIT,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        };
+
+        VkImage image;
+        if (vkCreateImage(device, &imageInfo, VK_NULL_HANDLE, &image) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create streamed texture image!");
+        }
+
+        VkDeviceMemory memory = allocateImageMemory(physicalDevice, device, image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        const VkImageSubresourceRange range = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = levelCount,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+        };
+
+        VkImageMemoryBarrier toTransfer = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = 0,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = image,
+                .subresourceRange = range,
+        };
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                             VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &toTransfer);
+
+        if (firstCopiedMip < mipCount) {
+            // Earlier frames may still be sampling the old image, its layout only changes once they are done
+            VkImageMemoryBarrier oldToTransfer = {
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                    .srcAccessMask = 0,
+                    .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+                    .oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .image = texture.image,
+                    .subresourceRange =
+                            {
+                                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                    .baseMipLevel = 0,
+                                    .levelCount = mipCount - texture.residentMip,
+                                    .baseArrayLayer = 0,
+                                    .layerCount = 1,
+                            },
+            };
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &oldToTransfer);
+
+            std::vector<VkImageCopy> copies;
+            for (uint32_t mip = firstCopiedMip; mip < mipCount; mip++) {
+                copies.push_back({
+                        .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mip - texture.residentMip, 0, 1},
+                        .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, mip - firstMip, 0, 1},
+                        .extent = {std::max(texture.width >> mip, 1u), std::max(texture.height >> mip, 1u), 1},
+                });
+            }
+            vkCmdCopyImage(commandBuffer, texture.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(copies.size()), copies.data());
+        }
+
+        std::vector<VkBufferImageCopy> regions;
+        for (uint32_t mip = firstMip; mip < firstCopiedMip; mip++) {
+            const std::vector<uint8_t> &data = texture.mips[mip];
+            memcpy(static_cast<uint8_t *>(slot.mapped) + stagingOffset, data.data(), data.size());
+
+            regions.push_back({
+                    .bufferOffset = stagingOffset,
+                    .imageSubresource =
+                            {
+                                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                    .mipLevel = mip - firstMip,
+                                    .baseArrayLayer = 0,
+                                    .layerCount = 1,
+                            },
+                    .imageExtent = {std::max(texture.width >> mip, 1u), std::max(texture.height >> mip, 1u), 1},
+            });
+            stagingOffset += data.size();
+        }
+        if (!regions.empty()) {
+            vkCmdCopyBufferToImage(commandBuffer, slot.stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                   static_cast<uint32_t>(regions.size()), regions.data());
+        }
+
+        VkImageMemoryBarrier toShader = toTransfer;
+        toShader.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        toShader.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        toShader.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        toShader.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
+                             VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &toShader);
+
+        VkImageViewCreateInfo viewInfo = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .image = image,
+                .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                .format = texture.format,
+                .subresourceRange = range,
+        };
+        VkImageView view;
+        if (vkCreateImageView(device, &viewInfo, VK_NULL_HANDLE, &view) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create streamed texture image view!");
+        }
+
+        // Destroyed once the slot's fence shows both the copies above and earlier frames are done with it
+        retire(texture);
+        texture.image = image;
+        texture.memory = memory;
+        texture.view = view;
+        texture.residentMip = firstMip;
+        texture.residentBytes = mipRangeBytes(texture, firstMip, mipCount);
+        residentBytes += texture.residentBytes;
+    }
+}
+
+void TextureStreamer::retire(StreamedTexture &texture) {
+    if (VK_NULL_HANDLE == texture.image) { return; }
+
+    uploadSlots[currentSlot].retiredImages.push_back({texture.image, texture.memory, texture.view});
+    residentBytes -= texture.residentBytes;
+    texture.image = VK_NULL_HANDLE;
+    texture.memory = VK_NULL_HANDLE;
+    texture.view = VK_NULL_HANDLE;
+    texture.residentBytes = 0;
+}
+
+void TextureStreamer::destroyRetired(UploadSlot &slot) {
+    for (const auto &retired: slot.retiredImages) {
+        vkDestroyImageView(device, retired.view, VK_NULL_HANDLE);
+        vkDestroyImage(device, retired.image, VK_NULL_HANDLE);
+        vkFreeMemory(device, retired.memory, VK_NULL_HANDLE);
+    }
+    slot.retiredImages.clear();
+}
+
+void TextureStreamer::reserveStaging(UploadSlot &slot, VkDeviceSize size) {
+    if (size <= slot.stagingSize) { return; }
+
+    // Only grows past maxUploadBytesPerUpdate for a single mip larger than it, the slot's fence was already waited on
+    if (VK_NULL_HANDLE != slot.stagingBuffer) {
+        vkUnmapMemory(device, slot.stagingMemory);
+        vkDestroyBuffer(device, slot.stagingBuffer, VK_NULL_HANDLE);
+        vkFreeMemory(device, slot.stagingMemory, VK_NULL_HANDLE);
+    }
+
+    VkBufferCreateInfo bufferInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = size,
+            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+    if (vkCreateBuffer(device, &bufferInfo, VK_NULL_HANDLE, &slot.stagingBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create texture staging buffer!");
+    }
+
+    slot.stagingMemory =
+            allocateBufferMemory(physicalDevice, device, slot.stagingBuffer,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    vkMapMemory(device, slot.stagingMemory, 0, size, 0, &slot.mapped);
+    slot.stagingSize = size;
+}
+
+VkDeviceSize TextureStreamer::mipRangeBytes(const StreamedTexture &texture, uint32_t firstMip, uint32_t lastMip) {
+    VkDeviceSize bytes = 0;
+    for (size_t level = firstMip; level < lastMip; level++) { bytes += texture.mips[level].size(); }
+    return bytes;
+}
+
+std::vector<std::vector<uint8_t>> TextureStreamer::generateMips(uint32_t width, uint32_t height,
+                                                                std::vector<uint8_t> pixels, ColorSpace colorSpace) {
+    std::vector<std::vector<uint8_t>> mips;
+    mips.push_back(std::move(pixels));
+
+    // 2x2 box filter, odd edges reuse the last texel. sRGB colors are averaged in linear space, otherwise mips darken.
+    while (width > 1 || height > 1) {
+        const std::vector<uint8_t> &source = mips.back();
+        const uint32_t mipWidth = std::max(width / 2, 1u);
+        const uint32_t mipHeight = std::max(height / 2, 1u);
+        std::vector<uint8_t> mip(static_cast<size_t>(mipWidth) * mipHeight * 4);
+
+        for (uint32_t y = 0; y < mipHeight; y++) {
+            const uint32_t y0 = std::min(y * 2, height - 1);
+            const uint32_t y1 = std::min(y * 2 + 1, height - 1);
+            for (uint32_t x = 0; x < mipWidth; x++) {
+                const uint32_t x0 = std::min(x * 2, width - 1);
+                const uint32_t x1 = std::min(x * 2 + 1, width - 1);
+                for (uint32_t c = 0; c < 4; c++) {
+                    const uint8_t a = source[(static_cast<size_t>(y0) * width + x0) * 4 + c];
+                    const uint8_t b = source[(static_cast<size_t>(y0) * width + x1) * 4 + c];
+                    const uint8_t d = source[(static_cast<size_t>(y1) * width + x0) * 4 + c];
+                    const uint8_t e = source[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+                    uint8_t &texel = mip[(static_cast<size_t>(y) * mipWidth + x) * 4 + c];
+
+                    if (colorSpace == ColorSpace::Srgb && c < 3) {
+                        texel = linearToSrgb(
+                                (srgbToLinear(a) + srgbToLinear(b) + srgbToLinear(d) + srgbToLinear(e)) * 0.25f);
+                    } else {
+                        texel = static_cast<uint8_t>((a + b + d + e + 2) / 4);
+                    }
+                }
+            }
+        }
+
+        mips.push_back(std::move(mip));
+        width = mipWidth;
+        height = mipHeight;
+    }
+
+    return mips;
+}
+
+float TextureStreamer::srgbToLinear(uint8_t value) {
+    static const std::array<float, 256> table = []() {
+        std::array<float, 256> values{};
+        for (uint32_t i = 0; i < values.size(); i++) {
+            const float encoded = static_cast<float>(i) / 255.0f;
+            values[i] = encoded <= 0.04045f ? encoded / 12.92f : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table[value];
+}
+
+uint8_t TextureStreamer::linearToSrgb(float value) {
+    const float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(std::clamp(encoded, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
@@ -4,18 +4,29 @@
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 #include <algorithm>  // For std::clamp in chooseSwapExtent
+#include <array>
 #include <cstdint>    // For uint32_t
+#include <cmath>
 #include <cstring>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <limits>  // For std::numeric_limits in chooseSwapExtent
+#include <random>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
+#include "headers/memory.h"
 #include "headers/triangle.h"
 
 // Public
-VulkanStarterTriangle::VulkanStarterTriangle(int width, int height) {
+VulkanStarterTriangle::VulkanStarterTriangle(int width, int height, uint32_t viewCount, float gpuBudgetMs,
+                                             uint32_t benchmarkDrawCount) {
     this->width = width;
     this->height = height;
+    this->viewCount = viewCount;
+    this->gpuBudgetMs = gpuBudgetMs;
+    this->benchmarkDrawCount = benchmarkDrawCount;
     // TODO: Parametrize these values to the constructor
     this->validationLayers = {"VK_LAYER_KHRONOS_validation"};
     this->deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
@@ -34,21 +45,54 @@ VulkanStarterTriangle::VulkanStarterTriangle(int width, int height) {
 
     this->swapChain = VK_NULL_HANDLE;
     this->swapChainImageFormat = VK_FORMAT_UNDEFINED;
+
+    this->swapChainBlitSupported = false;
+    this->upscaleEnabled = false;
+    this->memoryBudgetSupported = false;
+    this->commandPool = VK_NULL_HANDLE;
+    this->pipelineLayout = VK_NULL_HANDLE;
+    this->opaquePipeline = VK_NULL_HANDLE;
+    this->transparentPipeline = VK_NULL_HANDLE;
+    this->objectSetLayout = VK_NULL_HANDLE;
+    this->objectSet = VK_NULL_HANDLE;
+    this->objectCapacity = 0;
+    this->materialSetLayout = VK_NULL_HANDLE;
+    this->materialBuffer = VK_NULL_HANDLE;
+    this->materialMemory = VK_NULL_HANDLE;
+    this->triangleMesh = 0;
+    this->meshTextureSetLayout = VK_NULL_HANDLE;
+    this->meshTextureSampler = VK_NULL_HANDLE;
+    this->meshPipelineLayout = VK_NULL_HANDLE;
+    this->meshPipeline = VK_NULL_HANDLE;
+    this->meshVertexBuffer = VK_NULL_HANDLE;
+    this->meshVertexMemory = VK_NULL_HANDLE;
+    this->meshIndexBuffer = VK_NULL_HANDLE;
+    this->meshIndexMemory = VK_NULL_HANDLE;
+    this->meshIndexCount = 0;
+    this->currentFrame = 0;
+    this->lastGpuTimeMs = 0.0f;
+    this->frameIndex = 0;
 }
 
 void VulkanStarterTriangle::run() {
-    initWindow();
+    // Every core except the one the main thread runs on
+    jobSystem.create(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+    // Must be the very first call to initialize GLFW, and has to happen before createInstance queries its extensions
+    glfwInit();
+
     initVulkan();
-    mainLoop();
+    if (benchmarkDrawCount > 0) {
+        benchmarkDrawList();
+    } else {
+        mainLoop();
+    }
     cleanup();
 }
 
 
 // Private
 void VulkanStarterTriangle::initWindow() {
-    // Must be the very first call to initialize GLFW
-    glfwInit();
-
     // GLFW was originally designed for OpenGL.
     // This WindowHint tells GLFW to not initialize the window ith OpenGL
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
@@ -57,17 +101,69 @@ void VulkanStarterTriangle::initWindow() {
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
 
     window = glfwCreateWindow(width, height, "Vulkan Triangle", VK_NULL_HANDLE, VK_NULL_HANDLE);
+
+    // Cached for chooseSwapExtent, the swapchain is created on a worker. The window is not resizable.
+    int w, h;
+    glfwGetFramebufferSize(window, &w, &h);
+    framebufferExtent = {static_cast<uint32_t>(w), static_cast<uint32_t>(h)};
 }
 
 void VulkanStarterTriangle::initVulkan() {
-    createInstance();
-    setupDebugMessenger();
-    createSurface();
-    pickPhysicalDevice();
-    createLogicalDevice();
-    createSwapChain();
-    createImageViews();
-    createGraphicsPipeline();
+    using JobHandle = JobSystem::JobHandle;
+
+    // Startup as a task graph: the window, the instance and the shader binaries do not depend on each other.
+    // GLFW window calls must happen on the main thread, which runs them while waiting at the end.
+    JobHandle windowCreated = jobSystem.schedule([this]() { initWindow(); }, {}, JobSystem::Affinity::MainThread);
+    JobHandle shadersLoaded = jobSystem.schedule([this]() { loadShaders(); });
+    JobHandle instanceCreated = jobSystem.schedule([this]() {
+        createInstance();
+        setupDebugMessenger();
+    });
+
+    JobHandle surfaceCreated = jobSystem.schedule([this]() { createSurface(); }, {instanceCreated, windowCreated});
+    JobHandle deviceCreated = jobSystem.schedule(
+            [this]() {
+                pickPhysicalDevice();
+                createLogicalDevice();
+            },
+            {surfaceCreated});
+
+    // Everything below only needs the device and can be created concurrently
+    JobHandle swapChainCreated = jobSystem.schedule(
+            [this]() {
+                createSwapChain();
+                createImageViews();
+            },
+            {deviceCreated});
+    JobHandle commandPoolCreated = jobSystem.schedule([this]() { createCommandPool(); }, {deviceCreated});
+    JobHandle frameResourcesCreated = jobSystem.schedule([this]() { createFrameResources(); }, {commandPoolCreated});
+    JobHandle streamerCreated = jobSystem.schedule([this]() { createTextureStreamer(); }, {deviceCreated});
+    JobHandle targetCreated = jobSystem.schedule([this]() { createScaledRenderTarget(); }, {swapChainCreated});
+    JobHandle uniformsCreated = jobSystem.schedule([this]() { createFrameUniforms(); }, {deviceCreated});
+    JobHandle materialsCreated = jobSystem.schedule([this]() { createMaterials(); }, {uniformsCreated});
+    // The pipelines are built against the render pass of the scaled target and both descriptor set layouts
+    JobHandle pipelineCreated = jobSystem.schedule([this]() { createGraphicsPipeline(); },
+                                                   {targetCreated, materialsCreated, shadersLoaded});
+    JobHandle sceneCreated = jobSystem.schedule([this]() { createScene(); }, {pipelineCreated});
+    JobHandle meshCreated = jobSystem.schedule([this]() { createDemoMesh(); }, {deviceCreated});
+    JobHandle meshPipelineCreated =
+            jobSystem.schedule([this]() { createMeshPipeline(); }, {targetCreated, shadersLoaded});
+
+    std::vector<JobHandle> initialized = {sceneCreated, meshCreated, meshPipelineCreated, frameResourcesCreated,
+                                          streamerCreated};
+    if (viewCount > 0) {
+        initialized.push_back(
+                jobSystem.schedule([this]() { createMultiviewRenderer(); }, {swapChainCreated, shadersLoaded}));
+    } else if (benchmarkDrawCount == 0) {
+        // Not waited on, the textures register on the main thread once their mips are generated and the mesh is
+        // drawn as soon as the first one is resident
+        jobSystem.schedule([this]() { loadMeshTextures(); }, {streamerCreated});
+    }
+
+    jobSystem.wait(jobSystem.schedule([]() {}, initialized));
+
+    // Jobs only record what they report, tables printed from concurrent jobs would interleave
+    printStartupStats();
 }
 
 void VulkanStarterTriangle::createInstance() {
@@ -82,7 +178,7 @@ void VulkanStarterTriangle::createInstance() {
             .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
             .pEngineName = "No Engine",
             .engineVersion = VK_MAKE_VERSION(1, 0, 0),
-            .apiVersion = VK_API_VERSION_1_0,
+            .apiVersion = VK_API_VERSION_1_1,  // vkGetPhysicalDeviceMemoryProperties2 for the memory budget
     };
 
     // Fetch all the required Instance Extensions
@@ -116,14 +212,59 @@ void VulkanStarterTriangle::createInstance() {
 }
 
 void VulkanStarterTriangle::mainLoop() {
+    lastStatsTime = std::chrono::steady_clock::now();
+
     // Keep the window open until it is closed (or an error occurs)
-    while (!glfwWindowShouldClose(window)) { glfwPollEvents(); }
+    while (!glfwWindowShouldClose(window)) {
+        glfwPollEvents();
+        jobSystem.runMainThreadJobs();
+        textureStreamer.update(frameIndex);
+        if (viewCount > 0) {
+            renderMultiview();
+        } else {
+            drawFrame();
+        }
+
+        if (std::chrono::steady_clock::now() - lastStatsTime >= statsInterval) {
+            printFrameStats();
+            lastStatsTime = std::chrono::steady_clock::now();
+        }
+        frameIndex++;
+    }
 }
 
 void VulkanStarterTriangle::cleanup() {
+    jobSystem.destroy();
 #ifndef NDEBUG
     DestroyDebugUtilsMessengerEXT(instance, debugMessenger, VK_NULL_HANDLE);
 #endif
+    vkDeviceWaitIdle(device);
+    multiviewRenderer.destroy();
+    textureStreamer.destroy();
+    for (uint32_t i = 0; i < inFlightFences.size(); i++) {
+        vkDestroySemaphore(device, imageAvailableSemaphores[i], VK_NULL_HANDLE);
+        vkDestroySemaphore(device, renderFinishedSemaphores[i], VK_NULL_HANDLE);
+        vkDestroyFence(device, inFlightFences[i], VK_NULL_HANDLE);
+    }
+    vkDestroyPipeline(device, meshPipeline, VK_NULL_HANDLE);
+    vkDestroyPipelineLayout(device, meshPipelineLayout, VK_NULL_HANDLE);
+    vkDestroySampler(device, meshTextureSampler, VK_NULL_HANDLE);
+    vkDestroyDescriptorSetLayout(device, meshTextureSetLayout, VK_NULL_HANDLE);
+    vkDestroyBuffer(device, meshIndexBuffer, VK_NULL_HANDLE);
+    vkFreeMemory(device, meshIndexMemory, VK_NULL_HANDLE);
+    vkDestroyBuffer(device, meshVertexBuffer, VK_NULL_HANDLE);
+    vkFreeMemory(device, meshVertexMemory, VK_NULL_HANDLE);
+    vkDestroyPipeline(device, transparentPipeline, VK_NULL_HANDLE);
+    vkDestroyPipeline(device, opaquePipeline, VK_NULL_HANDLE);
+    vkDestroyPipelineLayout(device, pipelineLayout, VK_NULL_HANDLE);
+    descriptorAllocator.destroy();
+    vkDestroyDescriptorSetLayout(device, materialSetLayout, VK_NULL_HANDLE);
+    vkDestroyBuffer(device, materialBuffer, VK_NULL_HANDLE);
+    vkFreeMemory(device, materialMemory, VK_NULL_HANDLE);
+    vkDestroyDescriptorSetLayout(device, objectSetLayout, VK_NULL_HANDLE);
+    objectRing.destroy();
+    scaledRenderTarget.destroy();
+    vkDestroyCommandPool(device, commandPool, VK_NULL_HANDLE);
     for (auto imageView: swapChainImageViews) { vkDestroyImageView(device, imageView, VK_NULL_HANDLE); }
     vkDestroySwapchainKHR(device, swapChain, VK_NULL_HANDLE);
     vkDestroyDevice(device, VK_NULL_HANDLE);
@@ -184,6 +325,10 @@ void VulkanStarterTriangle::pickPhysicalDevice() {
         throw std::runtime_error("Failed to find suitable GPU!");
     }
     physicalDevice = selectedDevice;
+
+    // Optional: lets texture streaming track the real device local budget instead of guessing from the heap size
+    memoryBudgetSupported = isDeviceExtensionSupported(physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (memoryBudgetSupported) { deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME); }
 }
 
 void VulkanStarterTriangle::createLogicalDevice() {
@@ -206,8 +351,35 @@ void VulkanStarterTriangle::createLogicalDevice() {
 
     VkPhysicalDeviceFeatures deviceFeatures{};
 
+    // Multiview is core in 1.1 but still has to be enabled explicitly
+    VkPhysicalDeviceMultiviewFeatures multiviewFeatures = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES,
+    };
+    if (viewCount > 0) {
+        // Querying features through vkGetPhysicalDeviceFeatures2 is only valid on a 1.1 device
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        if (properties.apiVersion < VK_API_VERSION_1_1) {
+            throw std::runtime_error("Multiview rendering requested, but the GPU does not support Vulkan 1.1!");
+        }
+
+        VkPhysicalDeviceFeatures2 supportedFeatures = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                .pNext = &multiviewFeatures,
+        };
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures);
+        if (!multiviewFeatures.multiview) {
+            throw std::runtime_error("Multiview rendering requested, but not supported!");
+        }
+    }
+    multiviewFeatures.pNext = VK_NULL_HANDLE;
+    multiviewFeatures.multiview = VK_TRUE;
+    multiviewFeatures.multiviewGeometryShader = VK_FALSE;
+    multiviewFeatures.multiviewTessellationShader = VK_FALSE;
+
     VkDeviceCreateInfo createInfo{
             .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+            .pNext = viewCount > 0 ? &multiviewFeatures : VK_NULL_HANDLE,
             .queueCreateInfoCount = 1,
             .pQueueCreateInfos = queueCreateInfos.data(),
             .enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size()),
@@ -293,6 +465,18 @@ bool VulkanStarterTriangle::checkDeviceExtensionSupport(VkPhysicalDevice pDevice
     return requiredExtensions.empty();
 }
 
+bool VulkanStarterTriangle::isDeviceExtensionSupported(VkPhysicalDevice pDevice, const char *extensionName) {
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(pDevice, VK_NULL_HANDLE, &extensionCount, VK_NULL_HANDLE);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(pDevice, VK_NULL_HANDLE, &extensionCount, availableExtensions.data());
+
+    return std::any_of(availableExtensions.begin(), availableExtensions.end(), [&](const VkExtensionProperties &ext) {
+        return strcmp(ext.extensionName, extensionName) == 0;
+    });
+}
+
 void VulkanStarterTriangle::createSwapChain() {
     SwapChainSupportDetails swapChainSupport = querySwapChainSupport(physicalDevice);
 
@@ -313,9 +497,13 @@ void VulkanStarterTriangle::createSwapChain() {
             .imageColorSpace = surfaceFormat.colorSpace,
             .imageExtent = extent,
             .imageArrayLayers = 1,                              // Must always be 1, except for Stereoscopic 3D
-            .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,  // Directly render to screen without any postprocessing
+            .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
     };
 
+    // The scaled render target is blitted onto it, only requested when dynamic resolution is on
+    swapChainBlitSupported = swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    if (gpuBudgetMs > 0.0f && swapChainBlitSupported) { createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT; }
+
     QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
     uint32_t queueFamilyIndices[] = {
             indices.graphicsFamily.value(),
@@ -381,12 +569,46 @@ void VulkanStarterTriangle::createImageViews() {
     }
 }
 
+void VulkanStarterTriangle::loadShaders() {
+    vertShaderCode = readFile("../build/vert.spv");
+    fragShaderCode = readFile("../build/frag.spv");
+    meshVertShaderCode = readFile("../build/mesh_vert.spv");
+    meshFragShaderCode = readFile("../build/mesh_frag.spv");
+    if (viewCount > 0) { multiviewVertShaderCode = readFile("../build/multiview_vert.spv"); }
+}
+
 void VulkanStarterTriangle::createGraphicsPipeline() {
-    auto vertShaderCode = readFile("../build/vert.spv");
-    auto fragShaderCode = readFile("../build/frag.spv");
+    std::array<VkDescriptorSetLayout, 2> setLayouts{};
+    setLayouts[DrawList::materialSetIndex] = materialSetLayout;
+    setLayouts[DrawList::objectSetIndex] = objectSetLayout;
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = static_cast<uint32_t>(setLayouts.size()),
+            .pSetLayouts = setLayouts.data(),
+    };
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, VK_NULL_HANDLE, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline layout!");
+    }
 
-    VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
-    VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+    opaquePipeline = createScenePipeline(false);
+    transparentPipeline = createScenePipeline(true);
+}
+
+VkPipeline VulkanStarterTriangle::createScenePipeline(bool transparent) {
+    // The triangle's vertices are hardcoded in the vertex shader
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+    };
+    return createPipeline(vertShaderCode, fragShaderCode, pipelineLayout, vertexInputInfo, transparent);
+}
+
+VkPipeline VulkanStarterTriangle::createPipeline(const std::vector<char> &vertCode, const std::vector<char> &fragCode,
+                                                 VkPipelineLayout layout,
+                                                 const VkPipelineVertexInputStateCreateInfo &vertexInput,
+                                                 bool transparent) {
+    VkShaderModule vertShaderModule = createShaderModule(vertCode);
+    VkShaderModule fragShaderModule = createShaderModule(fragCode);
 
     VkPipelineShaderStageCreateInfo vertShaderStageInfo = {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
@@ -404,10 +626,838 @@ void VulkanStarterTriangle::createGraphicsPipeline() {
 
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
 
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+            .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+            .primitiveRestartEnable = VK_FALSE,
+    };
+
+    // Viewport and scissor follow the render scale, so they are set per frame
+    VkPipelineViewportStateCreateInfo viewportState = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+            .viewportCount = 1,
+            .scissorCount = 1,
+    };
+
+    VkPipelineRasterizationStateCreateInfo rasterizer = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+            .depthClampEnable = VK_FALSE,
+            .rasterizerDiscardEnable = VK_FALSE,
+            .polygonMode = VK_POLYGON_MODE_FILL,
+            .cullMode = VK_CULL_MODE_BACK_BIT,
+            .frontFace = VK_FRONT_FACE_CLOCKWISE,
+            .depthBiasEnable = VK_FALSE,
+            .lineWidth = 1.0f,
+    };
+
+    VkPipelineMultisampleStateCreateInfo multisampling = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+            .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+            .sampleShadingEnable = VK_FALSE,
+    };
+
+    // Opaque draws arrive front to back, so depth testing rejects hidden fragments early. Transparent draws are
+    // blended back to front, they are hidden by opaque geometry but must not hide each other.
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+            .depthTestEnable = VK_TRUE,
+            .depthWriteEnable = transparent ? VK_FALSE : VK_TRUE,
+            .depthCompareOp = VK_COMPARE_OP_LESS,
+            .depthBoundsTestEnable = VK_FALSE,
+            .stencilTestEnable = VK_FALSE,
+    };
+
+    // Transparent objects are blended at a constant 50% opacity
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {
+            .blendEnable = transparent ? VK_TRUE : VK_FALSE,
+            .srcColorBlendFactor = VK_BLEND_FACTOR_CONSTANT_ALPHA,
+            .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_CONSTANT_ALPHA,
+            .colorBlendOp = VK_BLEND_OP_ADD,
+            .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+            .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+            .alphaBlendOp = VK_BLEND_OP_ADD,
+            .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
+                              VK_COLOR_COMPONENT_A_BIT,
+    };
+
+    VkPipelineColorBlendStateCreateInfo colorBlending = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+            .logicOpEnable = VK_FALSE,
+            .attachmentCount = 1,
+            .pAttachments = &colorBlendAttachment,
+            .blendConstants = {0.0f, 0.0f, 0.0f, 0.5f},
+    };
+
+    std::vector<VkDynamicState> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+            .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
+            .pDynamicStates = dynamicStates.data(),
+    };
+
+    VkGraphicsPipelineCreateInfo pipelineInfo = {
+            .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+            .stageCount = 2,
+            .pStages = shaderStages,
+            .pVertexInputState = &vertexInput,
+            .pInputAssemblyState = &inputAssembly,
+            .pViewportState = &viewportState,
+            .pRasterizationState = &rasterizer,
+            .pMultisampleState = &multisampling,
+            .pDepthStencilState = &depthStencil,
+            .pColorBlendState = &colorBlending,
+            .pDynamicState = &dynamicState,
+            .layout = layout,
+            .renderPass = scaledRenderTarget.getRenderPass(),
+            .subpass = 0,
+    };
+    VkPipeline pipeline;
+    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, VK_NULL_HANDLE, &pipeline) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("Failed to create graphics pipeline!");
+    }
+
+    vkDestroyShaderModule(device, fragShaderModule, VK_NULL_HANDLE);
+    vkDestroyShaderModule(device, vertShaderModule, VK_NULL_HANDLE);
+    return pipeline;
+}
+
+void VulkanStarterTriangle::createMeshPipeline() {
+    VkDescriptorSetLayoutBinding textureBinding = {
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+    };
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindings = &textureBinding,
+    };
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, VK_NULL_HANDLE, &meshTextureSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create mesh texture descriptor set layout!");
+    }
+
+    // Streamed images only hold their resident mips, the sampler may use whichever are there
+    VkSamplerCreateInfo samplerInfo = {
+            .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+            .magFilter = VK_FILTER_LINEAR,
+            .minFilter = VK_FILTER_LINEAR,
+            .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+            .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+            .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+            .minLod = 0.0f,
+            .maxLod = VK_LOD_CLAMP_NONE,
+    };
+    if (vkCreateSampler(device, &samplerInfo, VK_NULL_HANDLE, &meshTextureSampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create mesh texture sampler!");
+    }
+
+    VkPushConstantRange pushConstantRange = {
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+            .offset = 0,
+            .size = sizeof(MeshDecodeConstants),
+    };
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+            .setLayoutCount = 1,
+            .pSetLayouts = &meshTextureSetLayout,
+            .pushConstantRangeCount = 1,
+            .pPushConstantRanges = &pushConstantRange,
+    };
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, VK_NULL_HANDLE, &meshPipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create mesh pipeline layout!");
+    }
+
+    VkVertexInputBindingDescription bindingDescription = PackedVertex::getBindingDescription();
+    auto attributeDescriptions = PackedVertex::getAttributeDescriptions();
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+            .vertexBindingDescriptionCount = 1,
+            .pVertexBindingDescriptions = &bindingDescription,
+            .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size()),
+            .pVertexAttributeDescriptions = attributeDescriptions.data(),
+    };
+
+    meshPipeline = createPipeline(meshVertShaderCode, meshFragShaderCode, meshPipelineLayout, vertexInputInfo, false);
+}
+
+void VulkanStarterTriangle::createDemoMesh() {
+    // UV sphere placed directly in clip space, mesh.vert has no camera transform
+    constexpr uint32_t rings = 32;
+    constexpr uint32_t segments = 64;
+    const glm::vec3 center(0.6f, -0.6f, 0.5f);
+    constexpr float radius = demoMeshRadius;
+
+    std::vector<MeshVertex> vertices;
+    for (uint32_t ring = 0; ring <= rings; ring++) {
+        float theta = glm::pi<float>() * static_cast<float>(ring) / static_cast<float>(rings);
+        for (uint32_t segment = 0; segment <= segments; segment++) {
+            float phi = glm::two_pi<float>() * static_cast<float>(segment) / static_cast<float>(segments);
+            glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            vertices.push_back({
+                    .position = center + radius * normal,
+                    .normal = normal,
+                    .uv = glm::vec2(static_cast<float>(segment) / segments, static_cast<float>(ring) / rings),
+                    .color = glm::vec4(normal * 0.5f + 0.5f, 1.0f),
+            });
+        }
+    }
+
+    // Clockwise on screen to match the front face of the scene pipelines, triangles collapsed at the poles are skipped
+    std::vector<uint32_t> indices;
+    for (uint32_t ring = 0; ring < rings; ring++) {
+        for (uint32_t segment = 0; segment < segments; segment++) {
+            uint32_t a = ring * (segments + 1) + segment;
+            uint32_t b = a + segments + 1;
+            uint32_t c = a + 1;
+            uint32_t d = b + 1;
+            if (ring != 0) { indices.insert(indices.end(), {a, b, c}); }
+            if (ring != rings - 1) { indices.insert(indices.end(), {c, b, d}); }
+        }
+    }
+
+    const float acmrBefore = MeshOptimizer::computeACMR(indices, vertices.size());
+    const size_t bytesBefore = vertices.size() * sizeof(MeshVertex);
+    QuantizedMesh mesh = MeshOptimizer::importMesh(std::move(vertices), std::move(indices));
+
+    meshIndexCount = static_cast<uint32_t>(mesh.indices.size());
+    meshDecode = mesh.decode;
+
+    // Small and written once, host visible memory avoids a staging upload at startup
+    auto createBuffer = [this](const void *data, VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer &buffer,
+                               VkDeviceMemory &memory) {
+        VkBufferCreateInfo bufferInfo = {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                .size = size,
+                .usage = usage,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        };
+        if (vkCreateBuffer(device, &bufferInfo, VK_NULL_HANDLE, &buffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create mesh buffer!");
+        }
+        memory = allocateBufferMemory(physicalDevice, device, buffer,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        void *mapped;
+        vkMapMemory(device, memory, 0, size, 0, &mapped);
+        std::memcpy(mapped, data, size);
+        vkUnmapMemory(device, memory);
+    };
+    createBuffer(mesh.vertices.data(), mesh.vertices.size() * sizeof(PackedVertex), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                 meshVertexBuffer, meshVertexMemory);
+    createBuffer(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t), VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                 meshIndexBuffer, meshIndexMemory);
+
+    meshImportStats = {
+            .vertices = mesh.vertices.size(),
+            .triangles = meshIndexCount / 3,
+            .acmrBefore = acmrBefore,
+            .acmrAfter = MeshOptimizer::computeACMR(mesh.indices, mesh.vertices.size()),
+            .vertexBytesBefore = bytesBefore,
+            .vertexBytesAfter = mesh.vertices.size() * sizeof(PackedVertex),
+    };
+}
+
+void VulkanStarterTriangle::createMaterials() {
+    VkDescriptorSetLayoutBinding binding = {
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+    };
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindings = &binding,
+    };
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, VK_NULL_HANDLE, &materialSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create material descriptor set layout!");
+    }
+
+    // Material data never changes, so every material gets an aligned slot of one buffer written once here
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    const VkDeviceSize alignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 1);
+    const VkDeviceSize stride = (sizeof(MaterialUniforms) + alignment - 1) / alignment * alignment;
+
+    VkBufferCreateInfo bufferInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = stride * materialCount,
+            .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+    if (vkCreateBuffer(device, &bufferInfo, VK_NULL_HANDLE, &materialBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create material buffer!");
+    }
+    materialMemory = allocateBufferMemory(physicalDevice, device, materialBuffer,
+                                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    void *mapped;
+    vkMapMemory(device, materialMemory, 0, bufferInfo.size, 0, &mapped);
+    for (uint32_t i = 0; i < materialCount; i++) {
+        // Tints spread around the hue circle
+        float hue = glm::two_pi<float>() * static_cast<float>(i) / static_cast<float>(materialCount);
+        MaterialUniforms material = {
+                .tint = glm::vec4(0.5f + 0.5f * std::cos(hue), 0.5f + 0.5f * std::cos(hue + 2.094f),
+                                  0.5f + 0.5f * std::cos(hue + 4.189f), 1.0f),
+        };
+        std::memcpy(static_cast<uint8_t *>(mapped) + stride * i, &material, sizeof(material));
+    }
+    vkUnmapMemory(device, materialMemory);
+
+    materialSets.resize(materialCount);
+    std::vector<VkDescriptorBufferInfo> bufferInfos(materialCount);
+    std::vector<VkWriteDescriptorSet> writes(materialCount);
+    for (uint32_t i = 0; i < materialCount; i++) {
+        materialSets[i] = descriptorAllocator.allocatePersistent(materialSetLayout);
+        bufferInfos[i] = {.buffer = materialBuffer, .offset = stride * i, .range = sizeof(MaterialUniforms)};
+        writes[i] = {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = materialSets[i],
+                .dstBinding = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                .pBufferInfo = &bufferInfos[i],
+        };
+    }
+    vkUpdateDescriptorSets(device, materialCount, writes.data(), 0, VK_NULL_HANDLE);
+}
+
+void VulkanStarterTriangle::createScene() {
+    const uint32_t opaque = drawList.addPipeline(opaquePipeline, pipelineLayout);
+    const uint32_t transparent = drawList.addPipeline(transparentPipeline, pipelineLayout);
+    for (auto materialSet: materialSets) { drawList.addMaterial(materialSet); }
+    // The triangle's vertices come from the vertex shader
+    triangleMesh = drawList.addMesh({.vertexBuffer = VK_NULL_HANDLE, .indexBuffer = VK_NULL_HANDLE, .count = 3});
+
+    // Fixed seed so every run shows the same scene
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<uint32_t> material(0, materialCount - 1);
+
+    sceneObjects.resize(sceneObjectCount);
+    for (auto &object: sceneObjects) {
+        bool isTransparent = unit(random) < 0.25f;
+        object = {
+                .position = glm::vec3(unit(random) * 1.8f - 0.9f, unit(random) * 1.8f - 0.9f, unit(random)),
+                .scale = 0.05f + 0.1f * unit(random),
+                .spin = 0.02f * (unit(random) - 0.5f),
+                .pipeline = isTransparent ? transparent : opaque,
+                .material = material(random),
+                .pass = isTransparent ? DrawList::Pass::Transparent : DrawList::Pass::Opaque,
+        };
+    }
+}
+
+uint32_t VulkanStarterTriangle::buildDrawList() {
+    // Every object's transform goes into one block of the ring, written in place
+    UniformRingBuffer::Allocation allocation = objectRing.allocate(sceneObjectCount * sizeof(glm::mat4));
+    auto *transforms = static_cast<glm::mat4 *>(allocation.data);
+
+    drawList.clear();
+    for (uint32_t i = 0; i < sceneObjectCount; i++) {
+        const SceneObject &object = sceneObjects[i];
+        transforms[i] = glm::scale(glm::rotate(glm::translate(glm::mat4(1.0f), object.position),
+                                               object.spin * static_cast<float>(frameIndex),
+                                               glm::vec3(0.0f, 0.0f, 1.0f)),
+                                   glm::vec3(object.scale));
+        drawList.add({
+                .pipeline = object.pipeline,
+                .material = object.material,
+                .mesh = triangleMesh,
+                .depth = object.position.z,
+                .pass = object.pass,
+                .object = i,
+        });
+    }
+    drawList.sort(jobSystem);
+    return allocation.dynamicOffset;
+}
+
+void VulkanStarterTriangle::benchmarkDrawList() {
+    // Separate list with more pipeline variants, so opaque draws spread over several pipelines like a real scene.
+    // Odd variants blend and take transparent draws.
+    DrawList benchmarkList;
+    std::vector<VkPipeline> pipelines(benchmarkPipelineCount);
+    for (uint32_t i = 0; i < benchmarkPipelineCount; i++) {
+        pipelines[i] = createScenePipeline(i % 2 == 1);
+        benchmarkList.addPipeline(pipelines[i], pipelineLayout);
+    }
+    for (auto materialSet: materialSets) { benchmarkList.addMaterial(materialSet); }
+    const uint32_t mesh = benchmarkList.addMesh({.vertexBuffer = VK_NULL_HANDLE, .indexBuffer = VK_NULL_HANDLE,
+                                                 .count = 3});
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<uint32_t> pipeline(0, benchmarkPipelineCount - 1);
+    std::uniform_int_distribution<uint32_t> material(0, materialCount - 1);
+
+    // Every draw owns a transform slot, its z matches the depth it is sorted by
+    std::vector<DrawList::Draw> draws(benchmarkDrawCount);
+    std::vector<glm::mat4> transforms(benchmarkDrawCount);
+    for (uint32_t i = 0; i < benchmarkDrawCount; i++) {
+        uint32_t pipelineIndex = pipeline(random);
+        draws[i] = {
+                .pipeline = pipelineIndex,
+                .material = material(random),
+                .mesh = mesh,
+                .depth = unit(random),
+                .pass = pipelineIndex % 2 == 1 ? DrawList::Pass::Transparent : DrawList::Pass::Opaque,
+                .object = i,
+        };
+        glm::vec3 position(unit(random) * 1.8f - 0.9f, unit(random) * 1.8f - 0.9f, draws[i].depth);
+        transforms[i] = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(0.05f));
+    }
+
+    VkCommandBuffer commandBuffer = commandBuffers[0];
+    for (bool sorted: {false, true}) {
+        double sortMs = 0.0;
+        double recordMs = 0.0;
+        double gpuMs = 0.0;
+        DrawList::BindStats totals{};
+
+        for (uint32_t iteration = 0; iteration < benchmarkIterations; iteration++) {
+            vkWaitForFences(device, 1, &inFlightFences[0], VK_TRUE, UINT64_MAX);
+            vkResetFences(device, 1, &inFlightFences[0]);
+
+            // The transform upload is the same in both modes and not measured
+            objectRing.beginFrame(0);
+            UniformRingBuffer::Allocation allocation = objectRing.allocate(benchmarkDrawCount * sizeof(glm::mat4));
+            std::memcpy(allocation.data, transforms.data(), benchmarkDrawCount * sizeof(glm::mat4));
+
+            benchmarkList.clear();
+            for (const auto &draw: draws) { benchmarkList.add(draw); }
+
+            auto sortStart = std::chrono::steady_clock::now();
+            if (sorted) { benchmarkList.sort(jobSystem); }
+            auto recordStart = std::chrono::steady_clock::now();
+
+            vkResetCommandBuffer(commandBuffer, 0);
+            VkCommandBufferBeginInfo beginInfo = {
+                    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                    .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            };
+            vkBeginCommandBuffer(commandBuffer, &beginInfo);
+            scaledRenderTarget.beginScene(commandBuffer, 0, swapChainExtent);
+            DrawList::BindStats stats = benchmarkList.record(commandBuffer, objectSet, allocation.dynamicOffset);
+            scaledRenderTarget.endScene(commandBuffer, 0);
+            vkEndCommandBuffer(commandBuffer);
+            auto recordEnd = std::chrono::steady_clock::now();
+
+            VkSubmitInfo submitInfo = {
+                    .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                    .commandBufferCount = 1,
+                    .pCommandBuffers = &commandBuffer,
+            };
+            if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[0]) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to submit benchmark command buffer!");
+            }
+            vkWaitForFences(device, 1, &inFlightFences[0], VK_TRUE, UINT64_MAX);
+
+            sortMs += std::chrono::duration<double, std::milli>(recordStart - sortStart).count();
+            recordMs += std::chrono::duration<double, std::milli>(recordEnd - recordStart).count();
+            gpuMs += scaledRenderTarget.readGpuTimeMs(0).value_or(0.0f);
+            totals.draws += stats.draws;
+            totals.pipelineBinds += stats.pipelineBinds;
+            totals.materialBinds += stats.materialBinds;
+            totals.meshBinds += stats.meshBinds;
+            totals.descriptorBinds += stats.descriptorBinds;
+        }
+
+        std::cout << std::endl << "Draw List Benchmark: " << (sorted ? "Sorted" : "Unsorted") << std::endl;
+        std::cout << divider << std::endl;
+        printTableLine("Draws", std::format("{}", totals.draws / benchmarkIterations), 30, 30);
+        printTableLine("Pipeline Binds", std::format("{}", totals.pipelineBinds / benchmarkIterations), 30, 30);
+        printTableLine("Material Binds", std::format("{}", totals.materialBinds / benchmarkIterations), 30, 30);
+        printTableLine("Mesh Binds", std::format("{}", totals.meshBinds / benchmarkIterations), 30, 30);
+        printTableLine("Descriptor Binds", std::format("{}", totals.descriptorBinds / benchmarkIterations), 30, 30);
+        printTableLine("Sort ms", std::format("{:.3f}", sortMs / benchmarkIterations), 30, 30);
+        printTableLine("Record ms", std::format("{:.3f}", recordMs / benchmarkIterations), 30, 30);
+        printTableLine("GPU ms", std::format("{:.3f}", gpuMs / benchmarkIterations), 30, 30);
+        std::cout << divider << std::endl;
+    }
+
+    vkDeviceWaitIdle(device);
+    for (auto variant: pipelines) { vkDestroyPipeline(device, variant, VK_NULL_HANDLE); }
+}
+
+void VulkanStarterTriangle::createTextureStreamer() {
+    QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+    textureStreamer.create(physicalDevice, device, graphicsQueue, indices.graphicsFamily.value(),
+                           memoryBudgetSupported, textureBudgetCapBytes, maxFramesInFlight);
+}
+
+void VulkanStarterTriangle::loadMeshTextures() {
+    // Checkerboards of different colors, fine enough that every mip level looks different
+    for (uint32_t i = 0; i < meshTextureCount; i++) {
+        const glm::vec3 color = glm::vec3(i & 1u, (i >> 1) & 1u, 1.0f) * 255.0f;
+        std::vector<uint8_t> pixels(static_cast<size_t>(meshTextureSize) * meshTextureSize * 4);
+        for (uint32_t y = 0; y < meshTextureSize; y++) {
+            for (uint32_t x = 0; x < meshTextureSize; x++) {
+                const bool light = ((x / 16) + (y / 16)) % 2 == 0;
+                uint8_t *pixel = &pixels[(static_cast<size_t>(y) * meshTextureSize + x) * 4];
+                pixel[0] = light ? static_cast<uint8_t>(color.r) : 32;
+                pixel[1] = light ? static_cast<uint8_t>(color.g) : 32;
+                pixel[2] = light ? static_cast<uint8_t>(color.b) : 32;
+                pixel[3] = 255;
+            }
+        }
+
+        textureStreamer.addTextureAsync(jobSystem, meshTextureSize, meshTextureSize, std::move(pixels),
+                                        TextureStreamer::ColorSpace::Srgb,
+                                        [this](uint32_t texture) { meshTextures.push_back(texture); });
+    }
+}
+
+void VulkanStarterTriangle::createCommandPool() {
+    QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+
+    VkCommandPoolCreateInfo poolInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            .queueFamilyIndex = indices.graphicsFamily.value(),
+    };
+
+    if (vkCreateCommandPool(device, &poolInfo, VK_NULL_HANDLE, &commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create command pool!");
+    }
+}
+
+void VulkanStarterTriangle::createScaledRenderTarget() {
+    // Sized for the full swapchain, lower render scales only use a sub-rectangle of it
+    scaledRenderTarget.create(physicalDevice, device, swapChainImageFormat, swapChainExtent, swapChainImageFormat,
+                              maxFramesInFlight);
+
+    // Without dynamic resolution, or without a way to blit, frames are drawn straight into the swapchain at full size
+    upscaleEnabled = gpuBudgetMs > 0.0f && swapChainBlitSupported && scaledRenderTarget.isUpscaleSupported();
+    if (upscaleEnabled) {
+        resolutionController.configure({.gpuBudgetMs = gpuBudgetMs});
+    } else {
+        scaledRenderTarget.createSwapChainFramebuffers(swapChainImageViews, swapChainExtent);
+    }
+
+    // The offscreen color image is only allocated when something renders into it, the benchmark always does
+    if (upscaleEnabled || benchmarkDrawCount > 0) { scaledRenderTarget.createOffscreenFramebuffer(); }
+}
+
+void VulkanStarterTriangle::createFrameResources() {
+    commandBuffers.resize(maxFramesInFlight);
+    imageAvailableSemaphores.resize(maxFramesInFlight);
+    renderFinishedSemaphores.resize(maxFramesInFlight);
+    inFlightFences.resize(maxFramesInFlight);
+
+    VkCommandBufferAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = commandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = maxFramesInFlight,
+    };
+    if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate command buffers!");
+    }
+
+    VkSemaphoreCreateInfo semaphoreInfo = {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+    // Signaled so the first wait of every frame slot returns immediately
+    VkFenceCreateInfo fenceInfo = {.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, .flags = VK_FENCE_CREATE_SIGNALED_BIT};
+
+    for (uint32_t i = 0; i < maxFramesInFlight; i++) {
+        if (vkCreateSemaphore(device, &semaphoreInfo, VK_NULL_HANDLE, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
+            vkCreateSemaphore(device, &semaphoreInfo, VK_NULL_HANDLE, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
+            vkCreateFence(device, &fenceInfo, VK_NULL_HANDLE, &inFlightFences[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create frame synchronization objects!");
+        }
+    }
+}
+
+void VulkanStarterTriangle::createFrameUniforms() {
+    // Sized for whichever needs more transforms, the scene or the benchmark
+    objectCapacity = std::max(sceneObjectCount, benchmarkDrawCount);
+    const VkDeviceSize objectBytes = objectCapacity * sizeof(glm::mat4);
+    objectRing.create(physicalDevice, device, objectBytes, objectBytes, maxFramesInFlight,
+                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    descriptorAllocator.create(device, maxFramesInFlight);
+
+    VkDescriptorSetLayoutBinding binding = {
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+    };
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindings = &binding,
+    };
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, VK_NULL_HANDLE, &objectSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create object descriptor set layout!");
+    }
+
+    // The only descriptor write: the set always points at the whole ring, draws pick their chunk by dynamic offset
+    objectSet = descriptorAllocator.allocatePersistent(objectSetLayout);
+
+    VkDescriptorBufferInfo bufferInfo = {.buffer = objectRing.getBuffer(), .offset = 0, .range = objectBytes};
+    VkWriteDescriptorSet write = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = objectSet,
+            .dstBinding = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+            .pBufferInfo = &bufferInfo,
+    };
+    vkUpdateDescriptorSets(device, 1, &write, 0, VK_NULL_HANDLE);
+}
+
+void VulkanStarterTriangle::drawFrame() {
+    vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+
+    // The fence guarantees the timestamps last written by this frame slot are available
+    if (auto gpuTimeMs = scaledRenderTarget.readGpuTimeMs(currentFrame)) {
+        lastGpuTimeMs = *gpuTimeMs;
+        if (upscaleEnabled) { resolutionController.update(lastGpuTimeMs); }
+    }
+
+    // Everything this frame slot handed out last time is no longer in use by the GPU
+    objectRing.beginFrame(currentFrame);
+    descriptorAllocator.beginFrame(currentFrame);
+
+    // Built and sorted while the GPU may still be busy with the previous frame
+    const uint32_t objectOffset = buildDrawList();
+
+    uint32_t imageIndex;
+    VkResult result = vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, imageAvailableSemaphores[currentFrame],
+                                            VK_NULL_HANDLE, &imageIndex);
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        throw std::runtime_error("Failed to acquire swap chain image!");
+    }
+    vkResetFences(device, 1, &inFlightFences[currentFrame]);
+
+    VkCommandBuffer commandBuffer = commandBuffers[currentFrame];
+    vkResetCommandBuffer(commandBuffer, 0);
+
+    VkCommandBufferBeginInfo beginInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin recording command buffer!");
+    }
+
+    VkExtent2D renderExtent = swapChainExtent;
+    if (upscaleEnabled) {
+        renderExtent = ResolutionController::scaleExtent(swapChainExtent, resolutionController.getScale());
+        scaledRenderTarget.beginScene(commandBuffer, currentFrame, renderExtent);
+    } else {
+        scaledRenderTarget.beginDirectScene(commandBuffer, currentFrame, imageIndex);
+    }
+
+    drawDemoMesh(commandBuffer, renderExtent);
+
+    lastBindStats = drawList.record(commandBuffer, objectSet, objectOffset);
+    if (upscaleEnabled) {
+        scaledRenderTarget.endSceneAndUpscale(commandBuffer, currentFrame, swapChainImages[imageIndex],
+                                              swapChainExtent);
+    } else {
+        scaledRenderTarget.endScene(commandBuffer, currentFrame);
+    }
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record command buffer!");
+    }
+
+    // When upscaling, the swapchain image is first touched by the blit and the scene can render before it is acquired
+    VkPipelineStageFlags waitStage =
+            upscaleEnabled ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    VkSubmitInfo submitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &imageAvailableSemaphores[currentFrame],
+            .pWaitDstStageMask = &waitStage,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &commandBuffer,
+            .signalSemaphoreCount = 1,
+            .pSignalSemaphores = &renderFinishedSemaphores[currentFrame],
+    };
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit draw command buffer!");
+    }
+
+    VkPresentInfoKHR presentInfo = {
+            .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &renderFinishedSemaphores[currentFrame],
+            .swapchainCount = 1,
+            .pSwapchains = &swapChain,
+            .pImageIndices = &imageIndex,
+    };
+    vkQueuePresentKHR(presentQueue, &presentInfo);
+
+    currentFrame = (currentFrame + 1) % maxFramesInFlight;
+}
+
+void VulkanStarterTriangle::drawDemoMesh(VkCommandBuffer commandBuffer, VkExtent2D renderExtent) {
+    if (meshTextures.empty()) { return; }
+
+    // Screen space feedback: the sphere covers its diameter on screen, and as the texture wraps around it once, about
+    // twice as many texels are visible across it
+    const uint32_t texture = meshTextures[(frameIndex / meshTextureFrames) % meshTextures.size()];
+    const float diameterPixels = demoMeshRadius * static_cast<float>(renderExtent.height);
+    textureStreamer.requestMip(texture, TextureStreamer::mipForScreenCoverage(meshTextureSize, meshTextureSize,
+                                                                              2.0f * diameterPixels));
+
+    // Not uploaded by an update() yet
+    VkImageView textureView = textureStreamer.getImageView(texture);
+    if (VK_NULL_HANDLE == textureView) { return; }
+
+    // The view changes whenever the streamer changes residency, so the set is written for this frame only
+    VkDescriptorSet textureSet = descriptorAllocator.allocate(meshTextureSetLayout);
+    VkDescriptorImageInfo imageInfo = {
+            .sampler = meshTextureSampler,
+            .imageView = textureView,
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    };
+    VkWriteDescriptorSet write = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = textureSet,
+            .dstBinding = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .pImageInfo = &imageInfo,
+    };
+    vkUpdateDescriptorSets(device, 1, &write, 0, VK_NULL_HANDLE);
+
+    // Mesh imported through MeshOptimizer, decoded from the quantized vertex format in mesh.vert
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, meshPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, meshPipelineLayout, 0, 1, &textureSet, 0,
+                            VK_NULL_HANDLE);
+    vkCmdPushConstants(commandBuffer, meshPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshDecodeConstants),
+                       &meshDecode);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &meshVertexBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, meshIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexed(commandBuffer, meshIndexCount, 1, 0, 0, 0);
+}
+
+void VulkanStarterTriangle::createMultiviewRenderer() {
+    // Layered target is the same size and format as the swapchain so both paths render identical images
+    multiviewRenderer.create(physicalDevice, device, swapChainImageFormat, swapChainExtent, viewCount);
+
+    VkShaderModule vertShaderModule = createShaderModule(multiviewVertShaderCode);
+    VkShaderModule fragShaderModule = createShaderModule(fragShaderCode);
+
+    multiviewRenderer.createPipeline(vertShaderModule, fragShaderModule);
+
     vkDestroyShaderModule(device, fragShaderModule, VK_NULL_HANDLE);
     vkDestroyShaderModule(device, vertShaderModule, VK_NULL_HANDLE);
 }
 
+void VulkanStarterTriangle::printStartupStats() {
+    std::cout << std::endl << "Imported Mesh" << std::endl;
+    std::cout << divider << std::endl;
+    printTableLine("Vertices", std::format("{}", meshImportStats.vertices), 30, 30);
+    printTableLine("Triangles", std::format("{}", meshImportStats.triangles), 30, 30);
+    printTableLine("ACMR Before", std::format("{:.3f}", meshImportStats.acmrBefore), 30, 30);
+    printTableLine("ACMR After", std::format("{:.3f}", meshImportStats.acmrAfter), 30, 30);
+    printTableLine("Vertex Bytes Before", std::format("{}", meshImportStats.vertexBytesBefore), 30, 30);
+    printTableLine("Vertex Bytes After", std::format("{}", meshImportStats.vertexBytesAfter), 30, 30);
+    std::cout << divider << std::endl;
+
+    if (viewCount > 0) {
+        std::cout << std::endl << "Multiview Target" << std::endl;
+        std::cout << divider << std::endl;
+        printTableLine("Views", std::format("{}", viewCount), 30, 30);
+        printTableLine("Max Views Per Pass",
+                       std::format("{}", MultiviewRenderer::queryMaxViewCount(physicalDevice)), 30, 30);
+        printTableLine("Passes", std::format("{}", multiviewRenderer.getBatchCount()), 30, 30);
+        printTableLine("Layers", std::format("{}", multiviewRenderer.getLayerCount()), 30, 30);
+        std::cout << divider << std::endl;
+    }
+}
+
+void VulkanStarterTriangle::renderMultiview() {
+    // Cameras on a ring around the origin, all looking at the center
+    std::vector<glm::mat4> viewProjections(viewCount);
+    float aspect = static_cast<float>(swapChainExtent.width) / static_cast<float>(swapChainExtent.height);
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f);
+    projection[1][1] *= -1;  // Vulkan clip space has Y pointing down
+    for (uint32_t view = 0; view < viewCount; view++) {
+        float angle = glm::two_pi<float>() * static_cast<float>(view) / static_cast<float>(viewCount);
+        glm::vec3 eye(3.0f * std::cos(angle), 1.0f, 3.0f * std::sin(angle));
+        viewProjections[view] = projection * glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    // There is a single layered target and view buffer, so only one multiview frame is in flight. The matrices above
+    // were computed while the GPU was still busy with the previous one.
+    VkCommandBuffer commandBuffer = commandBuffers[0];
+    vkWaitForFences(device, 1, &inFlightFences[0], VK_TRUE, UINT64_MAX);
+    vkResetFences(device, 1, &inFlightFences[0]);
+    multiviewRenderer.setViewMatrices(viewProjections);
+
+    vkResetCommandBuffer(commandBuffer, 0);
+    VkCommandBufferBeginInfo beginInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    // The imported demo mesh, placed in world space and seen from every camera
+    multiviewRenderer.record(commandBuffer, [this](VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) {
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &meshVertexBuffer, &offset);
+        vkCmdBindIndexBuffer(commandBuffer, meshIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        // The decode constants lead MultiviewRenderer::PushConstants
+        vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshDecodeConstants),
+                           &meshDecode);
+        vkCmdDrawIndexed(commandBuffer, meshIndexCount, 1, 0, 0, 0);
+    });
+    vkEndCommandBuffer(commandBuffer);
+
+    VkSubmitInfo submitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &commandBuffer,
+    };
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFences[0]) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit multiview command buffer!");
+    }
+}
+
+void VulkanStarterTriangle::printFrameStats() {
+    TextureStreamer::Stats textureStats = textureStreamer.getStats();
+
+    std::cout << std::endl << "Frame Statistics" << std::endl;
+    std::cout << divider << std::endl;
+    printTableLine("Frame", std::format("{}", frameIndex), 30, 30);
+    if (viewCount == 0) {
+        VkExtent2D renderExtent = ResolutionController::scaleExtent(swapChainExtent, resolutionController.getScale());
+        printTableLine("Render Scale", std::format("{:.2f}", resolutionController.getScale()), 30, 30);
+        printTableLine("Render Extent", std::format("{} x {}", renderExtent.width, renderExtent.height), 30, 30);
+        printTableLine("GPU Frame ms", std::format("{:.2f}", lastGpuTimeMs), 30, 30);
+        std::string budget = gpuBudgetMs > 0.0f ? "Unsupported" : "Off";
+        if (upscaleEnabled) { budget = std::format("{:.2f}", gpuBudgetMs); }
+        printTableLine("GPU Budget ms", budget, 30, 30);
+
+        UniformRingBuffer::Stats objectStats = objectRing.getStats();
+        DescriptorAllocator::Stats descriptorStats = descriptorAllocator.getStats();
+        printTableLine("Object KiB / Frame (Peak)", std::format("{:.1f}", objectStats.peakBytes / 1024.0), 30, 30);
+        printTableLine("Object KiB Capacity", std::format("{:.1f}", objectStats.capacityBytes / 1024.0), 30, 30);
+        printTableLine("Descriptor Pools", std::format("{}", descriptorStats.poolCount), 30, 30);
+        printTableLine("Descriptor Sets / Frame", std::format("{}", descriptorStats.frameSets), 30, 30);
+        printTableLine("Draws", std::format("{}", lastBindStats.draws), 30, 30);
+        printTableLine("Pipeline Binds", std::format("{}", lastBindStats.pipelineBinds), 30, 30);
+        printTableLine("Material Binds", std::format("{}", lastBindStats.materialBinds), 30, 30);
+        printTableLine("Mesh Binds", std::format("{}", lastBindStats.meshBinds), 30, 30);
+        printTableLine("Descriptor Binds", std::format("{}", lastBindStats.descriptorBinds), 30, 30);
+    }
+    printTableLine("Texture Resident MiB", std::format("{:.1f}", textureStats.residentBytes / (1024.0 * 1024.0)), 30,
+                   30);
+    printTableLine("Texture Budget MiB", std::format("{:.1f}", textureStats.budgetBytes / (1024.0 * 1024.0)), 30, 30);
+    printTableLine("Texture Pending Requests", std::format("{}", textureStats.pendingRequests), 30, 30);
+    printTableLine("Texture Evictions", std::format("{}", textureStats.evictions), 30, 30);
+    printTableLine("Texture Evictions / Frame", std::format("{:.2f}", textureStats.evictionRate), 30, 30);
+    std::cout << divider << std::endl;
+}
+
 VkShaderModule VulkanStarterTriangle::createShaderModule(const std::vector<char> &code) {
     VkShaderModuleCreateInfo createInfo = {
             .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
@@ -480,10 +1530,7 @@ VkExtent2D VulkanStarterTriangle::chooseSwapExtent(const VkSurfaceCapabilitiesKH
     if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
         return capabilities.currentExtent;
     } else {
-        int w, h;
-        glfwGetFramebufferSize(window, &w, &h);
-
-        VkExtent2D actualExtent = {static_cast<uint32_t>(w), static_cast<uint32_t>(h)};
+        VkExtent2D actualExtent = framebufferExtent;
 
         actualExtent.width =
                 std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "headers/memory.h"
+#include "headers/uniforms.h"
+
+// Public
+void UniformRingBuffer::create(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize bytesPerFrame,
+                               VkDeviceSize range, uint32_t framesInFlight, VkBufferUsageFlags usage) {
+    this->device = device;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    const bool storage = usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    const VkDeviceSize maxRange =
+            storage ? properties.limits.maxStorageBufferRange : properties.limits.maxUniformBufferRange;
+    if (range == 0 || range > maxRange) {
+        throw std::runtime_error("Uniform ring buffer range exceeds the device's buffer range limit!");
+    }
+
+    // Dynamic offsets must be multiples of the alignment, so every region and chunk starts on one
+    alignment = std::max<VkDeviceSize>(storage ? properties.limits.minStorageBufferOffsetAlignment
+                                               : properties.limits.minUniformBufferOffsetAlignment,
+                                       1);
+    this->range = range;
+    regionSize = alignUp(std::max(bytesPerFrame, range), alignment);
+    regionBegin = 0;
+    offset = 0;
+    peakBytes = 0;
+
+    // The descriptor always reads range bytes, the tail keeps a chunk at the very end of the last region in bounds
+    VkBufferCreateInfo bufferInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = regionSize * framesInFlight + range,
+            .usage = usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+    if (vkCreateBuffer(device, &bufferInfo, VK_NULL_HANDLE, &buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create uniform ring buffer!");
+    }
+
+    memory = allocateBufferMemory(physicalDevice, device, buffer,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    void *data;
+    vkMapMemory(device, memory, 0, bufferInfo.size, 0, &data);
+    mapped = static_cast<uint8_t *>(data);
+}
+
+void UniformRingBuffer::destroy() {
+    if (VK_NULL_HANDLE == device) { return; }
+
+    vkUnmapMemory(device, memory);
+    vkDestroyBuffer(device, buffer, VK_NULL_HANDLE);
+    vkFreeMemory(device, memory, VK_NULL_HANDLE);
+    mapped = nullptr;
+    device = VK_NULL_HANDLE;
+}
+
+void UniformRingBuffer::beginFrame(uint32_t frame) {
+    peakBytes = std::max(peakBytes, offset - regionBegin);
+    regionBegin = regionSize * frame;
+    offset = regionBegin;
+}
+
+UniformRingBuffer::Allocation UniformRingBuffer::allocate(VkDeviceSize size) {
+    if (size > range) { throw std::runtime_error("Uniform block is larger than the ring buffer range!"); }
+    if (offset + size > regionBegin + regionSize) {
+        throw std::runtime_error("Uniform ring buffer frame region exhausted!");
+    }
+
+    Allocation allocation = {mapped + offset, static_cast<uint32_t>(offset)};
+    offset = alignUp(offset + size, alignment);
+    return allocation;
+}